@@ -1,80 +1,179 @@
+#include <stdio.h>
+#include <string.h>
 #include "GC9A01.hpp"
+#include "GC9A01_PixelKernels.hpp"
+#include "GC9A01_CommandLists.hpp"
+#include "GC9A01_Round.hpp"
+#include "GC9A01_Trig.hpp"
 
 GC9A01::GC9A01(spi_inst_t* spi_instance, unsigned char miso_pin, unsigned char cs_pin, unsigned char sck_pin, unsigned char mosi_pin, unsigned char rst_pin, unsigned char dc_pin)
- : spi_instance(spi_instance), cs_pin(cs_pin), sck_pin(sck_pin), mosi_pin(mosi_pin), rst_pin(rst_pin), dc_pin(dc_pin), pf(PF12BitsPerPixel), is_rgb(true) {
-    spi_init(this->spi_instance, 40 * 1000 * 1000);   // 40 MHz is fine
-    spi_set_format(
-        this->spi_instance,
-        8,              // bits
-        SPI_CPOL_0,     // CPOL = 0
-        SPI_CPHA_0,     // CPHA = 0
-        SPI_MSB_FIRST
-    );
-
-    gpio_set_function(dc_pin,   GPIO_FUNC_SIO);
-    gpio_set_function(cs_pin,   GPIO_FUNC_SIO);
-    gpio_set_function(rst_pin,  GPIO_FUNC_SIO);
-    gpio_set_function(sck_pin,  GPIO_FUNC_SPI);
-    gpio_set_function(mosi_pin, GPIO_FUNC_SPI);
+ : is_rgb(true), pf(PF12BitsPerPixel), dpi(COLMOD::DPI18BitPerPixel), spi_instance(spi_instance), miso_pin(miso_pin), cs_pin(cs_pin), sck_pin(sck_pin),
+   mosi_pin(mosi_pin), rst_pin(rst_pin), dc_pin(dc_pin),
+   dma(spi_instance), asyncBusy(false), asyncCallback(nullptr), asyncContext(nullptr),
+   scratch(chunkPool), scratchSize(sizeof(chunkPool)), pipelineHalf(0U), transactionDepth(0U),
+   windowX0(0U), windowY0(0U), windowX1(0U), windowY1(0U), windowKnown(false), nextRow(0U), pointerKnown(false),
+   roundClip(false), dither(false), streamX(0U), streamY(0U),
+   colorLut(nullptr), conversionVersion(0U) {
+    this->ResetStats();
+    GC9A01HAL::SpiInit(this->spi_instance, 40 * 1000 * 1000);   // 40 MHz is fine
+
+    GC9A01HAL::PinFunctionSio(dc_pin);
+    GC9A01HAL::PinFunctionSio(cs_pin);
+    GC9A01HAL::PinFunctionSio(rst_pin);
+    GC9A01HAL::PinFunctionSpi(sck_pin);
+    GC9A01HAL::PinFunctionSpi(mosi_pin);
     
     // Chip select is active-low, so we'll initialise it to a driven-high state
-    gpio_set_dir(cs_pin, GPIO_OUT);
-    gpio_set_dir(rst_pin, GPIO_OUT);
-    gpio_set_dir(dc_pin, GPIO_OUT);
-    gpio_put(cs_pin, ON);
-    gpio_put(rst_pin, ON);
+    GC9A01HAL::PinOutput(cs_pin);
+    GC9A01HAL::PinOutput(rst_pin);
+    GC9A01HAL::PinOutput(dc_pin);
+    GC9A01HAL::PinPut(cs_pin, ON);
+    GC9A01HAL::PinPut(rst_pin, ON);
 }
 
 GC9A01::~GC9A01() { }
 
-void GC9A01::WriteCycleSequence(const unsigned char command, const unsigned char data) const { 
-    gpio_put(this->rst_pin, ON);
-    
-    gpio_put(this->cs_pin, OFF);
-    gpio_put(this->dc_pin, OFF);
+void GC9A01::WriteCycleSequence(const unsigned char command, const unsigned char data) const {
+    this->WriteCycleSequence(command, &data, 1U);
+}
 
-    spi_write_blocking(this->spi_instance, &command, 1U);
-    
-    gpio_put(this->dc_pin, ON);
-    
-    spi_write_blocking(this->spi_instance, &data, 1U);
+void GC9A01::WriteCycleSequence(const unsigned char command, const unsigned char data[], const size_t dataSize) const {
+    // Never interleave with a payload that is still being streamed
+    this->WaitIdle();
+    this->TrackCommand(command, data, dataSize);
 
-    gpio_put(this->cs_pin, ON);
+    this->ChipSelect();
+    this->SendCommand(command);
+    if(0 < dataSize) {
+        this->WriteParameters(data, dataSize);
+    }
+    this->ChipDeselect();
 }
 
-void GC9A01::WriteCycleSequence(const unsigned char command, const unsigned char data[], const size_t dataSize) const { 
-    gpio_put(this->rst_pin, ON);
-    
-    gpio_put(this->cs_pin, OFF);
-    gpio_put(this->dc_pin, OFF);
+void GC9A01::TrackCommand(const unsigned char command, const unsigned char data[], const size_t dataSize) const {
+    switch (command)
+    {
+    case 0x01U: // Software reset
+        this->InvalidateAfterReset();
+        break;
+    case RegulativeCommandSet::ColumnAddressSet:
+    case RegulativeCommandSet::RowAddressSet:
+        // SetAddressWindow updates the shadow once both are sent
+        this->InvalidateWindow();
+        break;
+    case RegulativeCommandSet::COLMODPixelFormatSet:
+        // The conversions follow the MCU interface format (DBI), other values leave it unchanged on the panel
+        if (0U < dataSize) {
+            this->dpi = data[0] & 0x70U;
+            switch (data[0] & 0x07U)
+            {
+            case COLMOD::DBI12BitPerPixel:
+                this->pf = PF12BitsPerPixel;
+                break;
+            case COLMOD::DBI16BitPerPixel:
+                this->pf = PF16BitsPerPixel;
+                break;
+            case COLMOD::DBI18BitPerPixel:
+                this->pf = PF18BitsPerPixel;
+                break;
+            default:
+                break;
+            }
+            ++this->conversionVersion;
+        }
+        this->pointerKnown = false;
+        break;
+    case RegulativeCommandSet::MemoryWrite:
+    case RegulativeCommandSet::WriteMemoryContinue:
+    case RegulativeCommandSet::MemoryAccessControl:
+        // Sent by the application, the write pointer is not followed
+        this->pointerKnown = false;
+        break;
+    default:
+        break;
+    }
+}
 
-    spi_write_blocking(this->spi_instance, &command, 1U);
-    
-    gpio_put(this->dc_pin, ON);
-    
-    if(0 < dataSize) {
-        spi_write_blocking(this->spi_instance, data, dataSize);
+void GC9A01::SendCommand(const unsigned char command) const {
+    const unsigned long long start = this->StatTime();
+    GC9A01HAL::PinPut(this->dc_pin, OFF);
+    GC9A01HAL::SpiWrite(this->spi_instance, &command, 1U);
+    GC9A01HAL::PinPut(this->dc_pin, ON);
+    this->StatCommand(command);
+    this->StatBusWait(start);
+}
+
+void GC9A01::BeginTransaction() const {
+    if (0U == this->transactionDepth) {
+        this->WaitIdle();
+        GC9A01HAL::PinPut(this->cs_pin, OFF);
+        this->StatTransaction();
     }
+    ++this->transactionDepth;
+}
 
-    gpio_put(this->cs_pin, ON);
+void GC9A01::EndTransaction() const {
+    // Unbalanced, the depth would wrap and keep CS asserted for good
+    if (0U == this->transactionDepth) {
+        return;
+    }
+    --this->transactionDepth;
+    if (0U == this->transactionDepth) {
+        // An asynchronous write started in the transaction still needs CS
+        this->WaitIdle();
+        GC9A01HAL::PinPut(this->cs_pin, ON);
+    }
 }
 
 void GC9A01::SetAddressWindow(unsigned short x0, unsigned short y0, unsigned short x1, unsigned short y1) const {
     unsigned char data[4U];
 
-    // Column address (X)
-    data[0] = ((x0 & 0xFF00U) >> 8U);
-    data[1] = (x0 & 0xFFU);
-    data[2] = ((x1 & 0xFF00U) >> 8U);
-    data[3] = (x1 & 0xFFU);
-    this->WriteCycleSequence(RegulativeCommandSet::ColumnAddressSet, data, 4U);
+    // Column address (X), skipped when the panel already has it
+    if (!this->windowKnown || (x0 != this->windowX0) || (x1 != this->windowX1)) {
+        data[0] = ((x0 & 0xFF00U) >> 8U);
+        data[1] = (x0 & 0xFFU);
+        data[2] = ((x1 & 0xFF00U) >> 8U);
+        data[3] = (x1 & 0xFFU);
+        this->WriteCycleSequence(RegulativeCommandSet::ColumnAddressSet, data, 4U);
+    }
 
     // Row address (Y)
-    data[0] = ((y0 & 0xFF00U) >> 8U);
-    data[1] = (y0 & 0xFFU);
-    data[2] = ((y1 & 0xFF00U) >> 8U);
-    data[3] = (y1 & 0xFFU);
-    this->WriteCycleSequence(RegulativeCommandSet::RowAddressSet, data, 4U);
+    if (!this->windowKnown || (y0 != this->windowY0) || (y1 != this->windowY1)) {
+        data[0] = ((y0 & 0xFF00U) >> 8U);
+        data[1] = (y0 & 0xFFU);
+        data[2] = ((y1 & 0xFF00U) >> 8U);
+        data[3] = (y1 & 0xFFU);
+        this->WriteCycleSequence(RegulativeCommandSet::RowAddressSet, data, 4U);
+    }
+
+    this->windowX0 = x0;
+    this->windowY0 = y0;
+    this->windowX1 = x1;
+    this->windowY1 = y1;
+    this->windowKnown = true;
+    this->pointerKnown = false;
+}
+
+unsigned char GC9A01::OpenMemoryWrite(unsigned short x0, unsigned short y0, unsigned short w, unsigned short h) const {
+    const unsigned short x1 = x0 + w - 1U;
+    const unsigned short y1 = y0 + h - 1U;
+
+    this->streamX = x0;
+    this->streamY = y0;
+
+    if (this->pointerKnown && (x0 == this->windowX0) && (x1 == this->windowX1) && (y0 == this->nextRow) && (y1 <= this->windowY1)) {
+        // Right below the previous write, the panel carries on from its write pointer
+        this->nextRow = y1 + 1U;
+        this->pointerKnown = (this->nextRow <= this->windowY1);
+        return RegulativeCommandSet::WriteMemoryContinue;
+    }
+
+    // The window is left open down to the last row so that rows appended below can be continued.
+    // Exactly w * h pixels are sent, so the extra rows are never written by this call.
+    this->SetAddressWindow(x0, y0, x1, MAX_HEIGHT - 1U);
+    this->nextRow = y1 + 1U;
+    this->pointerKnown = (this->nextRow <= this->windowY1);
+    return RegulativeCommandSet::MemoryWrite;
 }
 
 void GC9A01::SetVerticalScrollArea(unsigned short topFixedArea, unsigned short verticalScrollArea) const {
@@ -89,116 +188,33 @@ void GC9A01::SetVerticalScrollArea(unsigned short topFixedArea, unsigned short v
 }
 
 void GC9A01::GetNewImageSize(const size_t pixelCount, size_t* outSize) const {
-    switch (this->pf)
-    {
-    case PF12BitsPerPixel:
-        // Two pixels become 3 bytes
-        *outSize = (pixelCount / 2) * 3;
-        break;
-    case PF16BitsPerPixel:
-        // One pixel is two bytes
-        *outSize = (pixelCount / 1) * 2;
-        break;
-    case PF18BitsPerPixel:
-        // One pixel is three bytes
-        *outSize = (pixelCount / 1) * 3;
-        break;
-    default:
-        break;
-    }
+    *outSize = GC9A01Kernels::OutputSize(this->pf, pixelCount);
 }
 
-void GC9A01::HandlePixels(const unsigned char originalPixels[], size_t * const originalIndex, unsigned char out[], size_t * const outIndex) const {
-    const unsigned char GREEN_SHIFT = 0U;
-    const unsigned char BLUE_SHIFT = (this->is_rgb ? 1U : 2U);
-    const unsigned char RED_SHIFT = (this->is_rgb ? 2U : 1U);
-
-    switch (this->pf)
-    {
-    case PF12BitsPerPixel:
-    {
-        // Two pixels become 3 bytes
-        const unsigned char red1 = originalPixels[*originalIndex + RED_SHIFT];
-        const unsigned char green1 = originalPixels[*originalIndex + GREEN_SHIFT];
-        const unsigned char blue1 = originalPixels[*originalIndex + BLUE_SHIFT];
-        const unsigned char red2 = originalPixels[*originalIndex + 3U + RED_SHIFT];
-        const unsigned char green2 = originalPixels[*originalIndex + 3U + GREEN_SHIFT];
-        const unsigned char blue2 = originalPixels[*originalIndex + 3U + BLUE_SHIFT];
-        // printf("red1: %d, green1: %d, blue1: %d, red2: %d, green2: %d, blue2: %d", red1, green1, blue1, red2, green2, blue2);
-        *originalIndex += 6U;
-        if (this->is_rgb) {
-            out[*outIndex] = (green1 & 0xF0U) | ((blue1 & 0xF0U) >> 4U); // Green 1 + Blue 1
-            ++*outIndex;
-            out[*outIndex] = (red1 & 0xF0U) | ((green2 & 0xF0U) >> 4U); // Red 1 + Green 2
-            ++*outIndex;
-            out[*outIndex] = (blue2 & 0xF0U) | ((red2 & 0xF0U) >> 4U); // Blue 2 + Red 2
-            ++*outIndex;
-        } else {
-            out[*outIndex] = (green1 & 0xF0U) | ((red1 & 0xF0U) >> 4U); // Green 1 + Red 1
-            ++*outIndex;
-            out[*outIndex] = (blue1 & 0xF0U) | ((green2 & 0xF0U) >> 4U); // Blue 1 + Green 2
-            ++*outIndex;
-            out[*outIndex] = (red2 & 0xF0U) | ((blue2 & 0xF0U) >> 4U); // Red 2 + Blue 2
-            ++*outIndex;
-        }
-        break;
-    }
-    case PF16BitsPerPixel: // RGB 565
-    {
-        unsigned char red = originalPixels[*originalIndex + RED_SHIFT];
-        unsigned char green = originalPixels[*originalIndex + GREEN_SHIFT];
-        unsigned char blue = originalPixels[*originalIndex + BLUE_SHIFT];
-        *originalIndex += 3U;
-        if (this->is_rgb) {
-            // out[outIndex] = (originalPixels[i] >> 3U) & 0x1FU; // Red (5 bits)
-            // out[outIndex] = (out[outIndex] << 3U) | (originalPixels[i + 1U] >> 5U); // Green (3bits)
-            out[*outIndex] = (green >> 2U) | (blue >> 6U); // Green (6 bits) + Blue (2 bits)
-            ++*outIndex;
-            // out[outIndex] = (originalPixels[i + 1U] >> 2U) & 0b111U; // Green (3bits)
-            // out[outIndex] = (out[outIndex] << 5U) | ((originalPixels[i + 2U] >> 3U) & 0x1FU); // Blue (5 bits)
-            out[*outIndex] = ((blue >> 3U) & 0x03U) | (red >> 3U); // Blue (3 bits) + Red (5 bits)
-            ++*outIndex;
-        } else {
-            out[*outIndex] = (green >> 2U) | (red >> 6U); // Green (6 bits) + Blue (2 bits)
-            ++*outIndex;
-            out[*outIndex] = ((red >> 3U) & 0x03U) | (blue >> 3U); // Blue (3 bits) + Red (5 bits)
-            ++*outIndex;
-        }
-        break;
-    }
-    case PF18BitsPerPixel:
-    {
-        // TODO: Fix this logic for the ixels
-        // 4 pixels per 9 bytes
-        out[*outIndex] = (originalPixels[*originalIndex] >> 2U) & 0x3FU; // Red (6 bits)
-        out[*outIndex] = (originalPixels[*originalIndex + 1U] >> 6U) & 0x03U; // Green (2 bits)
-        ++*outIndex;
-        out[*outIndex] = (originalPixels[*originalIndex + 1U] >> 2U) & 0x0FU; // Green (4 bits)
-        out[*outIndex] = (originalPixels[*originalIndex + 2U] >> 4U) & 0x0FU; // Blue (4 bits)
-        ++*outIndex;
-        out[*outIndex] = (originalPixels[*originalIndex + 2U] >> 4U) & 0x0FU; // Blue (2 bits)
-        ++*outIndex;
-        break;
-    }
-    default:
-    {
-        break;
-    }
+const GC9A01Kernels::ColorLut* GC9A01::GetActiveLut() const {
+    const ColorOrder order = (this->is_rgb ? ColorOrderRGB : ColorOrderBGR);
+    if ((nullptr != this->colorLut) && (this->colorLut->pf == this->pf) && (this->colorLut->order == order)) {
+        return this->colorLut;
     }
+    return nullptr;
+}
+
+void GC9A01::SetColorLut(const GC9A01Kernels::ColorLut* lut) {
+    this->colorLut = lut;
+    ++this->conversionVersion;
 }
 
 void GC9A01::ReMapToCorrectPixels(const unsigned char originalPixels[], const size_t pixelCount, unsigned char out[]) const {
-    const unsigned char GREEN_SHIFT = 0U;
-    const unsigned char BLUE_SHIFT = (this->is_rgb ? 1U : 2U);
-    const unsigned char RED_SHIFT = (this->is_rgb ? 2U : 1U);
-    // Green, Blue, Red
-    size_t outIndex = 0U;
-    const size_t loopsCount = pixelCount * 3;
-
-    for (size_t i = 0U; i < loopsCount; ) {
-        // i increase is handled inside HandlePixels
-        this->HandlePixels(originalPixels, &i, out, &outIndex);
+    const unsigned long long start = this->StatTime();
+    const GC9A01Kernels::ColorLut* const lut = this->GetActiveLut();
+    if (nullptr != lut) {
+        GC9A01Kernels::ConvertWithLut(*lut, originalPixels, pixelCount, out);
+    } else {
+        // The kernel is picked once for the whole transfer
+        const GC9A01Kernels::ConvertFunction convert = GC9A01Kernels::Select(this->pf, (this->is_rgb ? ColorOrderRGB : ColorOrderBGR));
+        convert(originalPixels, pixelCount, out);
     }
+    this->StatConvert(start);
 }
 
 void GC9A01::SetPartialArtea(unsigned short startRow, unsigned short endRow) const {
@@ -212,334 +228,417 @@ void GC9A01::SetPartialArtea(unsigned short startRow, unsigned short endRow) con
     this->WriteCycleSequence(RegulativeCommandSet::PartialArea, data, 4);
 }
 
-void GC9A01::FillImage(unsigned char image[], unsigned short x0, unsigned short y0, unsigned short w, unsigned short h) const {
-    const size_t pixelCount = w * h;
-    size_t outSize = 0U;
-    this->GetNewImageSize(pixelCount, &outSize);
-    unsigned char out[outSize];
-    ReMapToCorrectPixels(image, pixelCount, out);
-    this->SetAddressWindow(x0, y0, (x0 + w - 1U), (y0 + h - 1U));
-    this->WriteCycleSequence(RegulativeCommandSet::MemoryWrite, &out[0U], outSize);
-}
-
-void GC9A01::FillScreen(unsigned char r, unsigned char g, unsigned char b) const {
-    this->FillArea(r, g, b, 0, 0, 239, 239);
+void GC9A01::SetScratchBuffer(unsigned char buffer[], size_t bufferSize) {
+    if ((nullptr == buffer) || (bufferSize < (2U * 8U * RGB_COUNT))) {
+        this->scratch = this->chunkPool;
+        this->scratchSize = sizeof(this->chunkPool);
+    } else {
+        this->scratch = buffer;
+        this->scratchSize = bufferSize;
+    }
 }
 
-// TODO: Rework to use pixels properly
-void GC9A01::FillArea(unsigned char r, unsigned char g, unsigned char b, unsigned short x0, unsigned short y0, unsigned short w, unsigned short h) const {
-    const size_t loopsCount = MAX_HEIGHT * MAX_HEIGHT * RGB_COUNT;
-    unsigned char pixels[loopsCount] = {0U};
-    size_t jumpSize = 0U;
-    size_t outIndex = 0U;
-    unsigned char pixelArray[6U] = {0U};
-    
+size_t GC9A01::GetChunkPixels() const {
+    // One half of the scratch, rounded down so that the second half stays word aligned
+    const size_t halfSize = (this->scratchSize / 2U) & ~static_cast<size_t>(3U);
+    size_t pixels = 0U;
     switch (this->pf)
     {
     case PF12BitsPerPixel:
-        jumpSize = 6U;
-        pixelArray[0] = r;
-        pixelArray[1] = g;
-        pixelArray[2] = b;
-        pixelArray[3] = r;
-        pixelArray[4] = g;
-        pixelArray[5] = b;
+        pixels = (halfSize * 2U) / 3U;
         break;
     case PF16BitsPerPixel:
-        jumpSize = 3U;
-        pixelArray[0] = r;
-        pixelArray[1] = g;
-        pixelArray[2] = b;
-        break;
-    case PF18BitsPerPixel:
-        // TODO:
-        // jumpSize
+        pixels = halfSize / 2U;
         break;
     default:
+        pixels = halfSize / 3U;
         break;
     }
+    // Multiple of 8 keeps the pixel pairs of 12 bits whole and every chunk on the word aligned kernel path
+    return pixels & ~static_cast<size_t>(7U);
+}
 
-    size_t pixelArrayIndex = 0U;
-    for (size_t i = 0U; i < loopsCount; i += jumpSize) {
-        this->HandlePixels(pixelArray, &pixelArrayIndex, pixels, &outIndex);
-        pixelArrayIndex = 0U;
-    }
-    
-    this->SetAddressWindow(x0, y0, (x0 + w - 1U), (y0 + h - 1U));
-    this->WriteCycleSequence(RegulativeCommandSet::MemoryWrite, pixels, outIndex);
+void GC9A01::BeginMemoryWrite(unsigned char command) const {
+    // Never interleave with a payload that is still being streamed
+    this->WaitIdle();
+
+    this->ChipSelect();
+    this->SendCommand(command);
 }
 
-void GC9A01::CheckerboardTest() const {
-    unsigned char pixels[MAX_WIDTH * MAX_HEIGHT * RGB_COUNT] = {0U};
-    unsigned char color[6U] = {0U};
-    unsigned char blackArray[6] = {0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U};
-    unsigned char whiteArray[6] = {0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU};
+void GC9A01::EndMemoryWrite() const {
+    // Final flush, the last chunk may still be on its way
+    this->WaitDma();
+    this->ChipDeselect();
+}
+
+size_t GC9A01::ConvertStream(const unsigned char rgb[], size_t pixelCount, unsigned char out[]) const {
+    const unsigned long long start = this->StatTime();
+    const ColorOrder order = (this->is_rgb ? ColorOrderRGB : ColorOrderBGR);
+    const GC9A01Kernels::ColorLut* const lut = this->GetActiveLut();
     size_t outSize = 0U;
-    this->GetNewImageSize(MAX_WIDTH * MAX_HEIGHT, &outSize);
-    size_t colorIndex = 0U;
-    for (size_t x = 0; x < MAX_WIDTH; ++x) {
-        for (size_t y = 0; y < MAX_HEIGHT; ++y) {
-            size_t position = x * MAX_WIDTH * RGB_COUNT + y * RGB_COUNT;
-            if ((x / 10) % 2 ==  (y / 10) % 2) {
-                this->HandlePixels(whiteArray, &colorIndex, pixels, &position);
-            } else {
-                this->HandlePixels(blackArray, &colorIndex, pixels, &position);
-            }
-            colorIndex = 0U;
-        }
+    if (nullptr != lut) {
+        outSize = GC9A01Kernels::ConvertWithLut(*lut, rgb, pixelCount, out);
+    } else if (!this->dither) {
+        outSize = GC9A01Kernels::Select(this->pf, order)(rgb, pixelCount, out);
+    } else {
+        // The threshold of every pixel depends on where it lands in the open window
+        GC9A01Kernels::Cursor cursor = {this->streamX, this->streamY, this->windowX0, this->windowX1};
+        outSize = GC9A01Kernels::SelectDithered(this->pf, order)(rgb, pixelCount, out, &cursor);
+        this->streamX = cursor.x;
+        this->streamY = cursor.y;
     }
-    this->SetAddressWindow(0U, 0U, MAX_WIDTH - 1U, MAX_HEIGHT - 1U);
-    this->WriteCycleSequence(RegulativeCommandSet::MemoryWrite, pixels, outSize);
+    this->StatConvert(start);
+    return outSize;
 }
 
-void GC9A01::RainbowTest() const {
-    constexpr size_t pixelCount = MAX_WIDTH * MAX_HEIGHT;
-    unsigned char color[6U] = {0U};
-    size_t outSize = 0U;
-    size_t colorIndex = 0U;
-    float frequency = 0.026;
-    
-    this->GetNewImageSize(pixelCount, &outSize);
+void GC9A01::StreamPixels(const unsigned char rgb[], size_t pixelCount) const {
+    const size_t chunkPixels = this->GetChunkPixels();
+    const size_t halfSize = (this->scratchSize / 2U) & ~static_cast<size_t>(3U);
 
-    unsigned char pixels[pixelCount * RGB_COUNT] = {0U};
+    while (0U < pixelCount) {
+        const size_t count = (pixelCount < chunkPixels) ? pixelCount : chunkPixels;
+        unsigned char* const half = &this->scratch[this->pipelineHalf * halfSize];
 
-    for (size_t x = 0U; x < MAX_WIDTH; ++x) {
-        color[0] = sin(frequency * x + 0) * 127 + 128;
-        color[1] = sin(frequency * x + 2) * 127 + 128;
-        color[2] = sin(frequency * x + 4) * 127 + 128;
-        color[3] = sin(frequency * (x + 1) + 0) * 127 + 128;
-        color[4] = sin(frequency * (x + 1) + 2) * 127 + 128;
-        color[5] = sin(frequency * (x + 1) + 4) * 127 + 128;
-        for (size_t y = 0U; y < MAX_HEIGHT; ++y) {
-            size_t position = x * MAX_WIDTH * RGB_COUNT + y * RGB_COUNT;
-            this->HandlePixels(color, &colorIndex, pixels, &position);
-            colorIndex = 0U;
-        }
+        // Converting this half overlaps with DMA sending the other one
+        const size_t outSize = this->ConvertStream(rgb, count, half);
+        this->WaitDma();
+        this->StartPayload(half, outSize, nullptr, nullptr);
+
+        this->pipelineHalf ^= 1U;
+        rgb += count * RGB_COUNT;
+        pixelCount -= count;
     }
-    this->SetAddressWindow(0U, 0U, MAX_WIDTH - 1U, MAX_HEIGHT - 1U);
-    this->WriteCycleSequence(RegulativeCommandSet::MemoryWrite, pixels, outSize);
 }
 
-void GC9A01::Init() const {
-    // this->HardwareReset();
-    this->WriteCycleSequence(0x01, nullptr, 0); // Reset?
-
-    this->WriteCycleSequence(InterCommandSet::InterRegisterEnable1, nullptr, 0); // Inter Register Enable1
-    this->WriteCycleSequence(InterCommandSet::InterRegisterEnable2, nullptr, 0); // Inter Register Enable2
-	
-    // Undocumented in datasheet registers
-    this->WriteCycleSequence(0xEB, 0x14);
-    this->WriteCycleSequence(0x84, 0x60);
-    this->WriteCycleSequence(0x85, 0xF7);
-    this->WriteCycleSequence(0x86, 0xFC);
-    this->WriteCycleSequence(0x87, 0x28);
-    this->WriteCycleSequence(0x8E, 0x0F);
-    this->WriteCycleSequence(0x8F, 0xFC);
-    this->WriteCycleSequence(0x88, 0x0A);
-    this->WriteCycleSequence(0x89, 0x21);
-    this->WriteCycleSequence(0x8A, 0x00);
-    this->WriteCycleSequence(0x8B, 0x80);
-    this->WriteCycleSequence(0x8C, 0x01);
-    this->WriteCycleSequence(0x8D, 0x03);
-    
-    this->SetDisplayFunctionControl(DisplayFunctionControlOptions::GS_OFF | DisplayFunctionControlOptions::SS_OFF);
+void GC9A01::WritePixels(unsigned short x0, unsigned short y0, unsigned short w, unsigned short h, PixelSource source, void* context) const {
+    const size_t halfSize = (this->scratchSize / 2U) & ~static_cast<size_t>(3U);
+    // The source writes RGB888 into the half, a multiple of 8 keeps 12 bit pairs and word blocks whole
+    const size_t chunkPixels = (halfSize / RGB_COUNT) & ~static_cast<size_t>(7U);
+    size_t pixelCount = w * h;
+
+    this->BeginMemoryWrite(this->OpenMemoryWrite(x0, y0, w, h));
+    while (0U < pixelCount) {
+        const size_t count = (pixelCount < chunkPixels) ? pixelCount : chunkPixels;
+        unsigned char* const half = &this->scratch[this->pipelineHalf * halfSize];
+
+        source(context, count, half);
+        // In place, every kernel writes no further than what it has already read
+        const size_t outSize = this->ConvertStream(half, count, half);
+        this->WaitDma();
+        this->StartPayload(half, outSize, nullptr, nullptr);
+
+        this->pipelineHalf ^= 1U;
+        pixelCount -= count;
+    }
+    this->EndMemoryWrite();
+}
 
-    // this->WriteCycleSequence(RegulativeCommandSet::MemoryAccessControl, MemoryAccessControlOptions::BGR | MemoryAccessControlOptions::MX);
-    this->WriteCycleSequence(RegulativeCommandSet::MemoryAccessControl, MemoryAccessControlOptions::RGB | MemoryAccessControlOptions::MX);
-    this->WriteCycleSequence(RegulativeCommandSet::COLMODPixelFormatSet, COLMOD::DBI12BitPerPixel | COLMOD::DPI16BitPerPixel);
-    // this->WriteCycleSequence(RegulativeCommandSet::COLMODPixelFormatSet, COLMOD::DBI16BitPerPixel | COLMOD::DPI16BitPerPixel);
+void GC9A01::WriteNativePixels(unsigned short x0, unsigned short y0, unsigned short w, unsigned short h, NativePixelSource source, void* context) const {
+    const size_t halfSize = (this->scratchSize / 2U) & ~static_cast<size_t>(3U);
+    const size_t chunkPixels = this->GetChunkPixels();
+    size_t pixelCount = w * h;
 
-    // Undocumented in datasheet registers
-	unsigned char seqReg90[] = {0x08, 0x08, 0x08, 0x08};
-    this->WriteCycleSequence(0x90, seqReg90, 4U);
+    this->BeginMemoryWrite(this->OpenMemoryWrite(x0, y0, w, h));
+    while (0U < pixelCount) {
+        const size_t count = (pixelCount < chunkPixels) ? pixelCount : chunkPixels;
+        unsigned char* const half = &this->scratch[this->pipelineHalf * halfSize];
 
-    this->SetTearingEffectControl(false, 0x01);
+        const size_t outSize = source(context, count, half);
+        this->WaitDma();
+        this->StartPayload(half, outSize, nullptr, nullptr);
 
-    this->WriteCycleSequence(0xBD, 0x06);
-    this->WriteCycleSequence(0xBC, 0x00);
+        this->pipelineHalf ^= 1U;
+        pixelCount -= count;
+    }
+    this->EndMemoryWrite();
+}
 
-	unsigned char seqRegFF[] = {0x60, 0x01, 0x04};
-    this->WriteCycleSequence(0xFF, seqRegFF, 3U);
+size_t GC9A01::ConvertPixels(const unsigned char rgb[], size_t pixelCount, unsigned char out[]) const {
+    this->ReMapToCorrectPixels(rgb, pixelCount, out);
+    return this->GetImageBufferSize(pixelCount, 1U);
+}
 
-    this->WriteCycleSequence(InterCommandSet::PowerControl2, 0x48);
-    this->WriteCycleSequence(InterCommandSet::PowerControl3, 0x48);
-    this->WriteCycleSequence(InterCommandSet::PowerControl4, 0x25);
+void GC9A01::FillImage(unsigned char image[], unsigned short x0, unsigned short y0, unsigned short w, unsigned short h) const {
+    if (!this->roundClip) {
+        // One MemoryWrite for the whole image, only the scratch buffer worth of pixels is converted at a time
+        this->BeginMemoryWrite(this->OpenMemoryWrite(x0, y0, w, h));
+        this->StreamPixels(image, w * h);
+        this->EndMemoryWrite();
+        return;
+    }
 
-    // Undocumented in datasheet register
-    this->WriteCycleSequence(0xBE, 0x11);
-	unsigned char seqRegE1[] = {0x10, 0x0E};
-    this->WriteCycleSequence(0xE1, seqRegE1, 2U);
+    // One window per run of rows with the same chord, each row streams only its visible part
+    this->BeginTransaction();
+    for (unsigned short y = y0; y < (y0 + h); ) {
+        unsigned short left = 0U;
+        unsigned short count = 0U;
+        unsigned short rows = GC9A01Round::GetRun(y, y0 + h, x0, w, &left, &count);
+        if ((PF12BitsPerPixel == this->pf) && (0U != (count & 1U))) {
+            // The pixel pairs of 12 bits cannot straddle the rows of a run
+            rows = 1U;
+        }
+        if (0U < count) {
+            this->BeginMemoryWrite(this->OpenMemoryWrite(left, y, count, rows));
+            for (unsigned short row = y; row < (y + rows); ++row) {
+                this->StreamPixels(&image[((row - y0) * w + (left - x0)) * RGB_COUNT], count);
+            }
+            this->EndMemoryWrite();
+        }
+        y += rows;
+    }
+    this->EndTransaction();
+}
 
-	unsigned char seqRegDF[] = {0x21, 0x10, 0x02};
-    this->WriteCycleSequence(0xDF, seqRegDF, 3U);
+bool GC9A01::BlitNative(const unsigned char pixels[], unsigned short x0, unsigned short y0, unsigned short w, unsigned short h, PixelFormat pf) const {
+    if (pf != this->pf) {
+        // The panel would unpack the bytes with a different layout
+        return false;
+    }
+    this->BeginMemoryWrite(this->OpenMemoryWrite(x0, y0, w, h));
+    this->StartPayload(pixels, this->GetImageBufferSize(w, h), nullptr, nullptr);
+    this->EndMemoryWrite();
+    return true;
+}
 
-	// gamma control sequence
-	unsigned char seqGamma1_3[] = {0x4b, 0x0F, 0x0A, 0x0B, 0x15, 0x30};
-    this->WriteCycleSequence(InterCommandSet::SetGamma1, seqGamma1_3, 6U);
-	unsigned char seqGamma2_4[] = {0x43, 0x70, 0x72, 0x36, 0x37, 0x6F};
-    this->WriteCycleSequence(InterCommandSet::SetGamma2, seqGamma2_4, 6U);
-    this->WriteCycleSequence(InterCommandSet::SetGamma3, seqGamma1_3, 6U);
-    this->WriteCycleSequence(InterCommandSet::SetGamma4, seqGamma2_4, 6U);
-    
-	unsigned char seqTearScanline[] = {0x00, 0x00};
-    this->WriteCycleSequence(RegulativeCommandSet::SetTearScanline, seqTearScanline, 2U);
-    
-	// Undocumented in datasheet register
-	unsigned char seqRegED[] = {0x1B, 0x0B};
-    this->WriteCycleSequence(0xED, seqRegED, 2U);
+size_t GC9A01::GetImageBufferSize(unsigned short w, unsigned short h) const {
+    size_t outSize = 0U;
+    this->GetNewImageSize(w * h, &outSize);
+    return outSize;
+}
 
-    this->WriteCycleSequence(0xAC, 0x47);
-    this->WriteCycleSequence(0xAE, 0x77);
-    this->WriteCycleSequence(0xCD, 0x63);
-    
-    // Unsure what this line (from manufacturer's boilerplate code) is
-    // meant to do, but users reported issues, seems to work OK without:
-	unsigned char seqReg70[] = {0x07, 0x09, 0x04, 0x0C, 0x0D, 0x09, 0x07, 0x08, 0x03};
-    this->WriteCycleSequence(0x70, seqReg70, 9U);
+size_t GC9A01::GetFillPattern(unsigned char r, unsigned char g, unsigned char b, unsigned char pattern[GC9A01DMA::MAX_REPEAT_PATTERN]) const {
+    const unsigned char pixelPair[6U] = {r, g, b, r, g, b};
+    const size_t pixelCount = (PF12BitsPerPixel == this->pf) ? 2U : 1U;
+    this->ReMapToCorrectPixels(pixelPair, pixelCount, pattern);
+    return this->GetImageBufferSize(pixelCount, 1U);
+}
 
-    // Frame Rate
-    this->SetFrameRate(FrameRateOptions::FourDotInversion);
+void GC9A01::BeginAsyncMemoryWrite(unsigned char command, TransferCompleteCallback callback, void* context) const {
+    this->BeginMemoryWrite(command);
 
-	// Undocumented in datasheet registers
-	unsigned char seqReg60[] = {0x38, 0x0B, 0x76, 0x62, 0x39, 0xF0, 0x76, 0x62};
-    this->WriteCycleSequence(0x60, seqReg60, 8U);
+    this->asyncBusy = true;
+    this->asyncCallback = callback;
+    this->asyncContext = context;
+    // CS stays asserted until AsyncTransferComplete
+}
 
-	unsigned char seqReg61[] = {0x38, 0xF6, 0x76, 0x62, 0x38, 0xF7, 0x76, 0x62};
-    this->WriteCycleSequence(0x61, seqReg61, 8U);
+void GC9A01::AsyncTransferComplete(void* context) {
+    const GC9A01* const display = static_cast<const GC9A01*>(context);
 
-	unsigned char seqReg62[] = {0x38, 0x0D, 0x71, 0xED, 0x76, 0x62, 0x38, 0x0F, 0x71, 0xEF, 0x76, 0x62};
-    this->WriteCycleSequence(0x62, seqReg62, 12U);
+    display->ChipDeselect();
 
-	unsigned char seqReg63[] = {0x38, 0x11, 0x71, 0xF1, 0x76, 0x62, 0x38, 0x13, 0x71, 0xF3, 0x76, 0x62};
-    this->WriteCycleSequence(0x63, seqReg63, 12U);
+    const TransferCompleteCallback callback = display->asyncCallback;
+    void* const callbackContext = display->asyncContext;
+    display->asyncBusy = false;
+    if (nullptr != callback) {
+        callback(callbackContext);
+    }
+}
 
-	unsigned char seqReg64[] = {0x3B, 0x29, 0xF1, 0x01, 0xF1, 0x00, 0x0A};
-    this->WriteCycleSequence(0x64, seqReg64, 7U);
+bool GC9A01::IsBusy() const {
+    // Lets the host DMA simulation make progress
+    (void)this->dma.IsBusy();
+    return this->asyncBusy;
+}
 
-	unsigned char seqReg66[] = {0x3C, 0x00, 0xCD, 0x67, 0x45, 0x45, 0x10, 0x00, 0x00, 0x00};
-    this->WriteCycleSequence(0x66, seqReg66, 10U);
-    
-	unsigned char seqReg67[] = {0x00, 0x3C, 0x00, 0x00, 0x00, 0x01, 0x54, 0x10, 0x32, 0x98};
-    this->WriteCycleSequence(0x67, seqReg67, 10U);
+void GC9A01::WaitIdle() const {
+    while (this->asyncBusy) {
+        this->WaitDma();
+    }
+}
 
-	unsigned char seqPorchCtrl[] = {0x08, 0x09, 0x14};
-    this->WriteCycleSequence(ExtendedCommandSet::BlankingPorchControl, seqPorchCtrl, 3U);
+void GC9A01::FillImageAsync(const unsigned char image[], unsigned char out[], unsigned short x0, unsigned short y0, unsigned short w, unsigned short h,
+                            TransferCompleteCallback callback, void* context) const {
+    const size_t pixelCount = w * h;
+    const size_t outSize = this->GetImageBufferSize(w, h);
+    // out may still be read by the previous transfer
+    this->WaitIdle();
+    this->ReMapToCorrectPixels(image, pixelCount, out);
+    this->BeginAsyncMemoryWrite(this->OpenMemoryWrite(x0, y0, w, h), callback, context);
+    this->StartPayload(out, outSize, &GC9A01::AsyncTransferComplete, const_cast<GC9A01*>(this));
+}
 
-	// Undocumented in datasheet registers
-	unsigned char seqReg74[] = {0x10, 0x85, 0x80, 0x00, 0x00, 0x4E, 0x00};
-    this->WriteCycleSequence(0x74, seqReg74, 7U);
-    
-	unsigned char seqReg98[] = {0x3E, 0x07};
-    this->WriteCycleSequence(0x98, seqReg98, 2U);
+void GC9A01::FillAreaAsync(unsigned char r, unsigned char g, unsigned char b, unsigned short x0, unsigned short y0, unsigned short w, unsigned short h,
+                           TransferCompleteCallback callback, void* context) const {
+    unsigned char pattern[GC9A01DMA::MAX_REPEAT_PATTERN];
 
-    this->EnterNormalMode();
-    this->WriteCycleSequence(RegulativeCommandSet::TearingEffectLineOFF, nullptr, 0);
-    this->IdleModeOff();
-    this->TearingEffectOn(false);
-    this->InversionOn();
-    this->WakeUp();
-    sleep_ms(120);
-    this->DisplayOn();
+    // The pixel format may be changed by the transfer in flight
+    this->WaitIdle();
+    const size_t patternSize = this->GetFillPattern(r, g, b, pattern);
+    this->BeginAsyncMemoryWrite(this->OpenMemoryWrite(x0, y0, w, h), callback, context);
+    this->StartRepeatPayload(pattern, patternSize, this->GetImageBufferSize(w, h), &GC9A01::AsyncTransferComplete, const_cast<GC9A01*>(this));
 }
 
-void GC9A01::Adafruit_Init() const {
-    this->WriteCycleSequence(InterCommandSet::InterRegisterEnable2, nullptr, 0); // Inter Register Enable2
-
-    this->WriteCycleSequence(0xEB, 0x14);
-
-    this->WriteCycleSequence(InterCommandSet::InterRegisterEnable1, nullptr, 0); // Inter Register Enable1
-    this->WriteCycleSequence(InterCommandSet::InterRegisterEnable2, nullptr, 0); // Inter Register Enable2
-	
-    // Undocumented in datasheet registers
-    this->WriteCycleSequence(0xEB, 0x14);
-    this->WriteCycleSequence(0x84, 0x40);
-    this->WriteCycleSequence(0x85, 0xFF);
-    this->WriteCycleSequence(0x86, 0xFF);
-    this->WriteCycleSequence(0x87, 0xFF);
-    this->WriteCycleSequence(0x88, 0x0A);
-    this->WriteCycleSequence(0x89, 0x21);
-    this->WriteCycleSequence(0x8A, 0x00);
-    this->WriteCycleSequence(0x8B, 0x80);
-    this->WriteCycleSequence(0x8C, 0x01);
-    this->WriteCycleSequence(0x8D, 0x01);
-    this->WriteCycleSequence(0x8E, 0xFF);
-    this->WriteCycleSequence(0x8F, 0xFF);
-
-    this->WriteCycleSequence(RegulativeCommandSet::MemoryAccessControl, MemoryAccessControlOptions::RGB | MemoryAccessControlOptions::MX);
-
-    this->WriteCycleSequence(RegulativeCommandSet::COLMODPixelFormatSet, COLMOD::DBI16BitPerPixel);
-
-    // Undocumented in datasheet registers
-	const unsigned char seqReg90[] = {0x08, 0x08, 0x08, 0x08};
-    this->WriteCycleSequence(0x90, seqReg90, 4U);
-
-    this->WriteCycleSequence(0xBD, 0x06);
-    this->WriteCycleSequence(0xBC, 0x00);
-
-	const unsigned char seqRegFF[] = {0x60, 0x01, 0x04};
-    this->WriteCycleSequence(0xFF, seqRegFF, 3U);
-    
-    this->WriteCycleSequence(InterCommandSet::PowerControl2, 0x13);
-    this->WriteCycleSequence(InterCommandSet::PowerControl3, 0x13);
-    this->WriteCycleSequence(InterCommandSet::PowerControl4, 0x22);
-    
-    // Undocumented in datasheet register
-    this->WriteCycleSequence(0xBE, 0x11);
-	const unsigned char seqRegE1[] = {0x10, 0x0E};
-    this->WriteCycleSequence(0xE1, seqRegE1, 2U);
-
-	unsigned char seqRegDF[] = {0x21, 0x0C, 0x02};
-    this->WriteCycleSequence(0xDF, seqRegDF, 3U);
-
-	// gamma control sequence
-	unsigned char seqGamma1_3[] = {0x45, 0x09, 0x08, 0x08, 0x26, 0x2A};
-    this->WriteCycleSequence(InterCommandSet::SetGamma1, seqGamma1_3, 6U);
-	unsigned char seqGamma2_4[] = {0x43, 0x70, 0x72, 0x36, 0x37, 0x6F};
-    this->WriteCycleSequence(InterCommandSet::SetGamma2, seqGamma2_4, 6U);
-    this->WriteCycleSequence(InterCommandSet::SetGamma3, seqGamma1_3, 6U);
-    this->WriteCycleSequence(InterCommandSet::SetGamma4, seqGamma2_4, 6U);
-    
-	// Undocumented in datasheet register
-	unsigned char seqRegED[] = {0x1B, 0x0B};
-    this->WriteCycleSequence(0xED, seqRegED, 2U);
+void GC9A01::SetPixelFormat(PixelFormat pf) const {
+    static const unsigned char DBI[] = {COLMOD::DBI12BitPerPixel, COLMOD::DBI16BitPerPixel, COLMOD::DBI18BitPerPixel};
+    if (pf == this->pf) {
+        return;
+    }
+    // The RGB interface format is kept as last sent (Init(), Adafruit_Init() or the application), only the SPI side changes
+    this->WriteCycleSequence(RegulativeCommandSet::COLMODPixelFormatSet, this->dpi | DBI[pf]);
+}
 
-    this->WriteCycleSequence(0xAE, 0x77);
-    this->WriteCycleSequence(0xCD, 0x63);
-    
-    // Unsure what this line (from manufacturer's boilerplate code) is
-    // meant to do, but users reported issues, seems to work OK without:
-	// unsigned char seqReg70[] = {0x07, 0x09, 0x04, 0x0C, 0x0D, 0x09, 0x07, 0x08, 0x03};
-    // this->WriteCycleSequence(0x70, seqReg70, 9U);
+void GC9A01::FillImage(unsigned char image[], unsigned short x0, unsigned short y0, unsigned short w, unsigned short h, PixelFormat pf) const {
+    this->SetPixelFormat(pf);
+    this->FillImage(image, x0, y0, w, h);
+}
 
-    // Frame Rate
-    this->SetFrameRate(FrameRateOptions::FourDotInversion);
+void GC9A01::FillArea(unsigned char r, unsigned char g, unsigned char b, unsigned short x0, unsigned short y0, unsigned short w, unsigned short h,
+                      PixelFormat pf) const {
+    this->SetPixelFormat(pf);
+    this->FillArea(r, g, b, x0, y0, w, h);
+}
 
-	// Undocumented in datasheet registers
-	unsigned char seqReg62[] = {0x18, 0x0D, 0x71, 0xED, 0x70, 0x70, 0x18, 0x0F, 0x71, 0xEF, 0x70, 0x70};
-    this->WriteCycleSequence(0x62, seqReg62, 12U);
+void GC9A01::FillScreen(unsigned char r, unsigned char g, unsigned char b) const {
+    this->FillArea(r, g, b, 0U, 0U, MAX_WIDTH, MAX_HEIGHT);
+}
 
-	unsigned char seqReg63[] = {0x18, 0x11, 0x71, 0xF1, 0x70, 0x70, 0x18, 0x13, 0x71, 0xF3, 0x70, 0x70};
-    this->WriteCycleSequence(0x63, seqReg63, 12U);
+void GC9A01::FillArea(unsigned char r, unsigned char g, unsigned char b, unsigned short x0, unsigned short y0, unsigned short w, unsigned short h) const {
+    unsigned char pattern[GC9A01DMA::MAX_REPEAT_PATTERN];
+    const size_t patternSize = this->GetFillPattern(r, g, b, pattern);
+
+    if (!this->roundClip) {
+        // Exactly w * h pixels, the pattern is repeated by DMA so the stack use does not depend on the area
+        this->BeginMemoryWrite(this->OpenMemoryWrite(x0, y0, w, h));
+        this->StartRepeatPayload(pattern, patternSize, this->GetImageBufferSize(w, h), nullptr, nullptr);
+        this->EndMemoryWrite();
+        return;
+    }
 
-	unsigned char seqReg64[] = {0x28, 0x29, 0xF1, 0x01, 0xF1, 0x00, 0x07};
-    this->WriteCycleSequence(0x64, seqReg64, 7U);
+    // One repeat per run of rows with the same chord
+    this->BeginTransaction();
+    for (unsigned short y = y0; y < (y0 + h); ) {
+        unsigned short left = 0U;
+        unsigned short count = 0U;
+        const unsigned short rows = GC9A01Round::GetRun(y, y0 + h, x0, w, &left, &count);
+        if (0U < count) {
+            this->BeginMemoryWrite(this->OpenMemoryWrite(left, y, count, rows));
+            this->StartRepeatPayload(pattern, patternSize, this->GetImageBufferSize(count, rows), nullptr, nullptr);
+            this->EndMemoryWrite();
+        }
+        y += rows;
+    }
+    this->EndTransaction();
+}
 
-	unsigned char seqReg66[] = {0x3C, 0x00, 0xCD, 0x67, 0x45, 0x45, 0x10, 0x00, 0x00, 0x00};
-    this->WriteCycleSequence(0x66, seqReg66, 10U);
-    
-	unsigned char seqReg67[] = {0x00, 0x3C, 0x00, 0x00, 0x00, 0x01, 0x54, 0x10, 0x32, 0x98};
-    this->WriteCycleSequence(0x67, seqReg67, 10U);
+void GC9A01::CheckerboardTest() const {
+    alignas(4) unsigned char row[MAX_WIDTH * RGB_COUNT];
 
-	// Undocumented in datasheet registers
-	unsigned char seqReg74[] = {0x10, 0x85, 0x80, 0x00, 0x00, 0x4E, 0x00};
-    this->WriteCycleSequence(0x74, seqReg74, 7U);
-    
-	unsigned char seqReg98[] = {0x3E, 0x07};
-    this->WriteCycleSequence(0x98, seqReg98, 2U);
+    // Row by row through FillImage, which continues the write from one row to the next or clips it to the circle
+    this->BeginTransaction();
+    for (size_t x = 0; x < MAX_WIDTH; ++x) {
+        for (size_t y = 0; y < MAX_HEIGHT; ++y) {
+            size_t position = y * RGB_COUNT;
+            const unsigned char color = ((x / 10) % 2 ==  (y / 10) % 2) ? 0xFFU : 0x00U;
+            row[position] = color;
+            row[position + 1U] = color;
+            row[position + 2U] = color;
+        }
+        this->FillImage(row, 0U, x, MAX_WIDTH, 1U);
+    }
+    this->EndTransaction();
+}
 
-    this->TearingEffectOn(false);
-    this->InversionOn();
-    this->WakeUp();
-    sleep_ms(120);
-    this->DisplayOn();
+void GC9A01::RainbowTest() const {
+    // 0.026 rad per row and phases of 2 and 4 rad, as binary angles (see GC9A01Trig)
+    const unsigned int frequency = 271U;
+    const unsigned short greenPhase = 20861U;
+    const unsigned short bluePhase = 41722U;
+    alignas(4) unsigned char row[MAX_WIDTH * RGB_COUNT];
+
+    // Row by row through FillImage, which continues the write from one row to the next or clips it to the circle
+    this->BeginTransaction();
+    for (size_t x = 0U; x < MAX_WIDTH; ++x) {
+        const unsigned short angle = frequency * x;
+        const unsigned char red = ((GC9A01Trig::Sin(angle) * 127) >> 14) + 128;
+        const unsigned char green = ((GC9A01Trig::Sin(angle + greenPhase) * 127) >> 14) + 128;
+        const unsigned char blue = ((GC9A01Trig::Sin(angle + bluePhase) * 127) >> 14) + 128;
+        for (size_t y = 0U; y < MAX_HEIGHT; ++y) {
+            size_t position = y * RGB_COUNT;
+            row[position] = red;
+            row[position + 1U] = green;
+            row[position + 2U] = blue;
+        }
+        this->FillImage(row, 0U, x, MAX_WIDTH, 1U);
+    }
+    this->EndTransaction();
 }
+
+void GC9A01::SendCommandList(const unsigned char list[], size_t listSize) const {
+    // Never interleave with a payload that is still being streamed
+    this->WaitIdle();
+
+    // One CS assertion for the whole list, only D/CX moves between commands
+    this->ChipSelect();
+    size_t index = 0U;
+    while (index < listSize) {
+        const unsigned char command = list[index];
+        const unsigned char dataSize = list[index + 1U] & ~GC9A01CommandLists::DELAY;
+        const bool hasDelay = 0U != (list[index + 1U] & GC9A01CommandLists::DELAY);
+        index += 2U;
+
+        // The pixel format follows a COLMOD in the list as it does for WriteCycleSequence
+        this->TrackCommand(command, &list[index], dataSize);
+        this->SendCommand(command);
+        if (0U < dataSize) {
+            this->WriteParameters(&list[index], dataSize);
+            index += dataSize;
+        }
+        if (hasDelay) {
+            GC9A01HAL::SleepMs(list[index]);
+            ++index;
+        }
+    }
+    this->ChipDeselect();
+    // Lists may reset the panel or move the window
+    this->InvalidateWindow();
+}
+
+void GC9A01::Init() const {
+    // this->HardwareReset();
+    this->SendCommandList(GC9A01CommandLists::Init, sizeof(GC9A01CommandLists::Init));
+}
+
+void GC9A01::Adafruit_Init() const {
+    this->SendCommandList(GC9A01CommandLists::Adafruit_Init, sizeof(GC9A01CommandLists::Adafruit_Init));
+}
+
+#ifdef GC9A01_STATS
+float GC9A01::GetFrameRate() const {
+    if ((this->stats.frames < 2U) || (this->stats.lastFrameUs == this->stats.firstFrameUs)) {
+        return 0.0F;
+    }
+    return ((this->stats.frames - 1U) * 1000000.0F) / (this->stats.lastFrameUs - this->stats.firstFrameUs);
+}
+
+void GC9A01::ResetStats() const {
+    memset(&this->stats, 0, sizeof(this->stats));
+}
+
+void GC9A01::MarkFrame() const {
+    const unsigned long long now = GC9A01HAL::TimeUs();
+    if (0U == this->stats.frames) {
+        this->stats.firstFrameUs = now;
+    }
+    this->stats.lastFrameUs = now;
+    ++this->stats.frames;
+}
+
+void GC9A01::PrintStats() const {
+    const GC9A01Stats& s = this->stats;
+    printf("GC9A01 stats: %lu transactions, %llu parameter bytes, %llu pixel bytes\n", s.transactions, s.parameterBytes, s.pixelBytes);
+    printf("  convert %llu us, bus wait %llu us, %lu frames at %.2f fps\n", s.convertUs, s.busWaitUs, s.frames, this->GetFrameRate());
+    for (unsigned int command = 0U; command < 256U; ++command) {
+        if (0U != s.commandCounts[command]) {
+            printf("  0x%02X x %lu\n", command, s.commandCounts[command]);
+        }
+    }
+}
+#else
+void GC9A01::ResetStats() const { }
+
+void GC9A01::MarkFrame() const { }
+
+void GC9A01::PrintStats() const { }
+#endif
@@ -2,22 +2,37 @@
 #define GC9A01_HPP
 
 #include <math.h>
-#include "pico/stdlib.h"
-#include "hardware/spi.h"
+#include "GC9A01_HAL.hpp"
+#include "GC9A01_DMA.hpp"
 
 #define ON  1
 #define OFF 0
 
 #define MAX_HEIGHT 240U
+// Line of the panel scan in which the first row is refreshed, STS = 8 is Gate1 in the datasheet (see SetTearLine)
+#define FIRST_GATE_LINE 8U
 #define MAX_WIDTH 240U
 #define RGB_COUNT 3U
 
+// Rows of RGB666 the driver owned scratch buffer can hold, FillImage converts and sends one buffer at a time
+#ifndef GC9A01_CHUNK_ROWS
+#define GC9A01_CHUNK_ROWS 2U
+#endif
+
 typedef enum {
     PF12BitsPerPixel,
     PF16BitsPerPixel,
     PF18BitsPerPixel,
 } PixelFormat;
 
+/* Order the channels are sent to the panel in. The source pixels are always R, G, B bytes,
+ * ColorOrderBGR swaps red and blue on the way out.
+ * */
+typedef enum {
+    ColorOrderRGB,
+    ColorOrderBGR,
+} ColorOrder;
+
 typedef enum {
 #ifdef READ_SUPPORT
     ReadDisplayIdentificationInformation2 = 0x04,
@@ -212,11 +227,45 @@ namespace COLMOD {
     static constexpr unsigned char DBI18BitPerPixel = 0x06U;
 }
 
+namespace GC9A01Kernels {
+    struct ColorLut;
+}
+
+#ifdef GC9A01_STATS
+// Driver counters, see GC9A01::GetStats. Only compiled in with GC9A01_STATS.
+typedef struct {
+    // Commands sent, by opcode
+    unsigned long commandCounts[256];
+    // Bytes of command parameters and of pixel payload (DMA) sent
+    unsigned long long parameterBytes;
+    unsigned long long pixelBytes;
+    // CS assertions: transactions plus the commands and memory writes sent outside of one
+    unsigned long transactions;
+    // Time spent in the conversion kernels and blocked on the bus (blocking writes and waits for DMA)
+    unsigned long long convertUs;
+    unsigned long long busWaitUs;
+    // MarkFrame calls and the time of the first and the last one
+    unsigned long frames;
+    unsigned long long firstFrameUs;
+    unsigned long long lastFrameUs;
+} GC9A01Stats;
+#endif
+
 class GC9A01
 {
+public:
+    typedef void (*TransferCompleteCallback)(void* context);
+    // Writes the next pixelCount pixels of a WritePixels rectangle as RGB888 into rgb
+    typedef void (*PixelSource)(void* context, size_t pixelCount, unsigned char rgb[]);
+    // Writes the next pixelCount pixels of a WriteNativePixels rectangle in the panel format into out, returns the bytes written
+    typedef size_t (*NativePixelSource)(void* context, size_t pixelCount, unsigned char out[]);
 private:
+    // Order the channels are sent in, false swaps red and blue (see ColorOrder)
     bool is_rgb;
-    PixelFormat pf;
+    // Follows the COLMOD value last sent to the panel
+    mutable PixelFormat pf;
+    // RGB interface format (DPI bits) of the COLMOD value last sent, SetPixelFormat keeps it
+    mutable unsigned char dpi;
     spi_inst_t* spi_instance;
     unsigned char miso_pin;
     unsigned char cs_pin;
@@ -226,7 +275,152 @@ private:
     unsigned char dc_pin;
     void ReMapToCorrectPixels(const unsigned char originalPixels[], const size_t pixelCount, unsigned char out[]) const;
     void GetNewImageSize(const size_t pixelCount, size_t* outSize) const;
-    void HandlePixels(const unsigned char originalPixels[], size_t * const originalIndex, unsigned char out[], size_t * const outIndex) const;
+    // State of the asynchronous MemoryWrite in flight, updated from the DMA completion IRQ
+    mutable GC9A01DMA dma;
+    mutable volatile bool asyncBusy;
+    mutable TransferCompleteCallback asyncCallback;
+    mutable void* asyncContext;
+    /* Scratch the pixels are converted into before they are sent, chunkPool unless the application supplied one.
+     * It is split in two halves: the kernel fills one while DMA sends the other. */
+    alignas(4) mutable unsigned char chunkPool[MAX_WIDTH * GC9A01_CHUNK_ROWS * RGB_COUNT];
+    unsigned char* scratch;
+    size_t scratchSize;
+    mutable unsigned char pipelineHalf;
+    // Nesting level of BeginTransaction, CS is left to the outermost one while it is non zero
+    mutable unsigned int transactionDepth;
+    inline void ChipSelect() const {
+        if (0U == this->transactionDepth) {
+            GC9A01HAL::PinPut(this->cs_pin, OFF);
+            this->StatTransaction();
+        }
+    }
+    inline void ChipDeselect() const {
+        if (0U == this->transactionDepth) {
+            GC9A01HAL::PinPut(this->cs_pin, ON);
+        }
+    }
+    // Command phase: D/CX low for the command byte, left high for the parameters that follow
+    void SendCommand(const unsigned char command) const;
+    /* Shadow of the panel address window and of its write pointer (the row the next WriteMemoryContinue
+     * would start at, always at windowX0). Address commands are only sent when the window changes. */
+    mutable unsigned short windowX0;
+    mutable unsigned short windowY0;
+    mutable unsigned short windowX1;
+    mutable unsigned short windowY1;
+    mutable bool windowKnown;
+    mutable unsigned short nextRow;
+    mutable bool pointerKnown;
+    // Only the visible circle is sent by the fills (see SetRoundClip)
+    bool roundClip;
+    // Images are converted with the ordered dither kernels (see SetDither)
+    bool dither;
+    // Where the next streamed pixel lands, moved on by the dithered conversion
+    mutable unsigned short streamX;
+    mutable unsigned short streamY;
+#ifdef GC9A01_STATS
+    mutable GC9A01Stats stats;
+#endif
+    // Statistics hooks, they compile to nothing unless GC9A01_STATS is defined
+    inline unsigned long long StatTime() const {
+#ifdef GC9A01_STATS
+        return GC9A01HAL::TimeUs();
+#else
+        return 0U;
+#endif
+    }
+    inline void StatCommand(unsigned char command) const {
+#ifdef GC9A01_STATS
+        ++this->stats.commandCounts[command];
+#else
+        (void)command;
+#endif
+    }
+    inline void StatParameters(size_t bytes) const {
+#ifdef GC9A01_STATS
+        this->stats.parameterBytes += bytes;
+#else
+        (void)bytes;
+#endif
+    }
+    inline void StatTransaction() const {
+#ifdef GC9A01_STATS
+        ++this->stats.transactions;
+#endif
+    }
+    inline void StatConvert(unsigned long long start) const {
+#ifdef GC9A01_STATS
+        this->stats.convertUs += GC9A01HAL::TimeUs() - start;
+#else
+        (void)start;
+#endif
+    }
+    inline void StatBusWait(unsigned long long start) const {
+#ifdef GC9A01_STATS
+        this->stats.busWaitUs += GC9A01HAL::TimeUs() - start;
+#else
+        (void)start;
+#endif
+    }
+    // Blocking SPI write of command parameters
+    inline void WriteParameters(const unsigned char data[], size_t dataSize) const {
+        const unsigned long long start = this->StatTime();
+        GC9A01HAL::SpiWrite(this->spi_instance, data, dataSize);
+        this->StatParameters(dataSize);
+        this->StatBusWait(start);
+    }
+    // Waits for the DMA transfer in flight
+    inline void WaitDma() const {
+        const unsigned long long start = this->StatTime();
+        this->dma.WaitIdle();
+        this->StatBusWait(start);
+    }
+    // Hand a pixel payload to DMA
+    inline void StartPayload(const unsigned char data[], size_t dataSize, GC9A01DMA::CompletionCallback callback, void* context) const {
+#ifdef GC9A01_STATS
+        this->stats.pixelBytes += dataSize;
+#endif
+        this->dma.Start(data, dataSize, callback, context);
+    }
+    inline void StartRepeatPayload(const unsigned char pattern[], size_t patternSize, size_t totalSize, GC9A01DMA::CompletionCallback callback,
+                                   void* context) const {
+#ifdef GC9A01_STATS
+        this->stats.pixelBytes += totalSize;
+#endif
+        this->dma.StartRepeat(pattern, patternSize, totalSize, callback, context);
+    }
+    // Conversion table set with SetColorLut, nullptr for plain truncation
+    const GC9A01Kernels::ColorLut* colorLut;
+    mutable unsigned int conversionVersion;
+    // colorLut when it matches the current pixel format and color order, nullptr otherwise
+    const GC9A01Kernels::ColorLut* GetActiveLut() const;
+    inline void InvalidateWindow() const {
+        this->windowKnown = false;
+        this->pointerKnown = false;
+    }
+    // The panel is back to its reset defaults, COLMOD 66h included, after a software or hardware reset
+    inline void InvalidateAfterReset() const {
+        this->InvalidateWindow();
+        this->pf = PF18BitsPerPixel;
+        this->dpi = COLMOD::DPI18BitPerPixel;
+        ++this->conversionVersion;
+    }
+    // Drops the shadow state a command sent through WriteCycleSequence may invalidate
+    void TrackCommand(const unsigned char command, const unsigned char data[], const size_t dataSize) const;
+    // Sets up a write of w x h pixels, returns the command to start it with (MemoryWrite or WriteMemoryContinue)
+    unsigned char OpenMemoryWrite(unsigned short x0, unsigned short y0, unsigned short w, unsigned short h) const;
+    size_t GetChunkPixels() const;
+    // Converts the next pixels of the open memory write (see OpenMemoryWrite), dithered when SetDither is on
+    size_t ConvertStream(const unsigned char rgb[], size_t pixelCount, unsigned char out[]) const;
+    // CS and D/CX framing of a memory write, the payload is sent in between. EndMemoryWrite flushes the pipeline.
+    void BeginMemoryWrite(unsigned char command) const;
+    void EndMemoryWrite() const;
+    // Converts and queues rgb one chunk at a time, at 12 bits pixelCount has to be even except for the last call
+    void StreamPixels(const unsigned char rgb[], size_t pixelCount) const;
+    // Smallest run of wire bytes a solid color repeats with (a pixel pair at 12 bits, one pixel otherwise), returns its size
+    size_t GetFillPattern(unsigned char r, unsigned char g, unsigned char b, unsigned char pattern[GC9A01DMA::MAX_REPEAT_PATTERN]) const;
+    // Sends command (see OpenMemoryWrite) and marks the bus busy, the caller then hands the payload to DMA with AsyncTransferComplete
+    void BeginAsyncMemoryWrite(unsigned char command, TransferCompleteCallback callback, void* context) const;
+    static void AsyncTransferComplete(void* context);
 public:
     GC9A01(spi_inst_t* spi_instance, unsigned char miso_pin, unsigned char cs_pin, unsigned char sck_pin, unsigned char mosi_pin, unsigned char rst_pin, unsigned char dc_pin);
     ~GC9A01();
@@ -239,19 +433,134 @@ public:
     * */
     void WriteCycleSequence(const unsigned char command, const unsigned char data) const;
     void WriteCycleSequence(const unsigned char command, const unsigned char data[], const size_t dataSize) const;
+    /* Keep CS asserted from BeginTransaction to the matching EndTransaction. Every call in between
+     * (WriteCycleSequence, SetAddressWindow, FillImage, the inline command helpers, ...) then only moves D/CX
+     * between its command and data phases. Transactions nest, see GC9A01Transaction for a scoped one. An
+     * EndTransaction without a matching BeginTransaction is ignored.
+     * */
+    void BeginTransaction() const;
+    void EndTransaction() const;
+    /* Replays a byte coded command list (see GC9A01CommandLists for the format) with CS held low throughout,
+     * blocking until the last command and delay are done.
+     * */
+    void SendCommandList(const unsigned char list[], size_t listSize) const;
     void Init() const;
     void Adafruit_Init() const;
     void FillArea(unsigned char r, unsigned char g, unsigned char b, unsigned short x0, unsigned short y0, unsigned short w, unsigned short h) const;
     void FillScreen(unsigned char r, unsigned char g, unsigned char b) const;
-    void SetAddressWindow(unsigned short x0, unsigned short y0, unsigned short w, unsigned short h) const;
+    // Inclusive corners, ColumnAddressSet / RowAddressSet are only sent for what changed since the last call
+    void SetAddressWindow(unsigned short x0, unsigned short y0, unsigned short x1, unsigned short y1) const;
     void SetVerticalScrollArea(unsigned short topFixedArea, unsigned short verticalScrollArea) const;
     void SetPartialArtea(unsigned short startRow, unsigned short endRow) const;
     void FillImage(unsigned char image[], unsigned short x0, unsigned short y0, unsigned short w, unsigned short h) const;
+    /* Like FillImage, but the w x h pixels (row major) are pulled from source one chunk at a time instead of
+     * being read from an image, so they can come from a framebuffer in another format or be generated on
+     * the fly. Calls to source ask for a multiple of 8 pixels, except the last one.
+     * */
+    void WritePixels(unsigned short x0, unsigned short y0, unsigned short w, unsigned short h, PixelSource source, void* context) const;
+    /* WritePixels for sources that already produce the panel format (e.g. through a palette lookup table built with
+     * ConvertPixels), nothing is converted by the driver.
+     * */
+    void WriteNativePixels(unsigned short x0, unsigned short y0, unsigned short w, unsigned short h, NativePixelSource source, void* context) const;
+    // RGB888 to the current panel format and color order, returns GetImageBufferSize(pixelCount, 1)
+    size_t ConvertPixels(const unsigned char rgb[], size_t pixelCount, unsigned char out[]) const;
+    inline PixelFormat GetPixelFormat() const { return this->pf; }
+    /* Order the channels are sent in, for panels wired BGR without setting MemoryAccessControlOptions::BGR.
+     * Only the conversion changes, nothing is sent to the panel.
+     * */
+    inline void SetColorOrder(ColorOrder order) {
+        this->is_rgb = (ColorOrderRGB == order);
+        ++this->conversionVersion;
+    }
+    inline ColorOrder GetColorOrder() const { return this->is_rgb ? ColorOrderRGB : ColorOrderBGR; }
+    /* Switches the MCU interface pixel format with COLMODPixelFormatSet, nothing is sent when the panel already uses pf.
+     * The RGB interface format (DPI) of the last COLMOD value sent, e.g. by Init() or Adafruit_Init(), is kept.
+     * The frame memory keeps 18 bits per pixel whatever the interface format, so areas written at different depths
+     * coexist: e.g. 12 bits (1.5 bytes/pixel) for fast changing areas, 18 bits (3 bytes/pixel) for static artwork.
+     * The conversions, fills and GetImageBufferSize follow pf from then on (a COLMOD value sent through
+     * WriteCycleSequence is followed the same way).
+     * */
+    void SetPixelFormat(PixelFormat pf) const;
+    // FillImage / FillArea at pf, which stays the panel format afterwards (see SetPixelFormat)
+    void FillImage(unsigned char image[], unsigned short x0, unsigned short y0, unsigned short w, unsigned short h, PixelFormat pf) const;
+    void FillArea(unsigned char r, unsigned char g, unsigned char b, unsigned short x0, unsigned short y0, unsigned short w, unsigned short h,
+                  PixelFormat pf) const;
+    /* Round panel mode: FillArea, FillScreen, FillImage and the test patterns only send the pixels inside the visible
+     * circle (see GC9A01Round), every run of rows that share a chord as a window of its own. A full screen is then
+     * 21.5 % fewer payload bytes, for 11 bytes of addressing per run. The corners of the frame memory are left as
+     * they were. WritePixels, BlitNative and the asynchronous writes keep sending the whole rectangle.
+     * */
+    inline void SetRoundClip(bool enabled) { this->roundClip = enabled; }
+    inline bool GetRoundClip() const { return this->roundClip; }
+    /* Ordered (4x4 Bayer) dither for FillImage, WritePixels and the test patterns: the pixels are quantized to the panel
+     * format with a threshold that depends on their screen position, so gradients come out as a fine even pattern
+     * instead of 16 (12 bits) or 32 (16 bits) visible bands. Makes 12 bits usable for photos and gradients at
+     * 1.5 bytes per pixel. Solid fills, ConvertPixels and FillImageAsync are never dithered.
+     * */
+    inline void SetDither(bool enabled) { this->dither = enabled; }
+    inline bool GetDither() const { return this->dither; }
+    /* Converts every fill and image (and ConvertPixels) through lut instead of plain truncation, so gamma and brightness
+     * correction cost one lookup per channel (see GC9A01Kernels::ColorLut). The table is only used while its pixel
+     * format and color order match the panel's, and takes precedence over SetDither. nullptr goes back to truncation.
+     * Call it again after rebuilding the table in place so that derived tables (GC9A01IndexedFrameBuffer) follow.
+     *
+     * @param lut has to outlive its use by the driver
+     * */
+    void SetColorLut(const GC9A01Kernels::ColorLut* lut);
+    // Changes whenever the RGB888 to panel format conversion does (pixel format or color table)
+    inline unsigned int GetConversionVersion() const { return this->conversionVersion; }
+#ifdef GC9A01_STATS
+    // Snapshot of the counters since construction or the last ResetStats()
+    inline GC9A01Stats GetStats() const { return this->stats; }
+    // Frames per second between the first and the last MarkFrame() call, 0 before two frames
+    float GetFrameRate() const;
+#endif
+    /* Statistics (GC9A01_STATS): ResetStats clears the counters, MarkFrame is called by the application once per
+     * displayed frame, PrintStats dumps the counters with printf. Without GC9A01_STATS they do nothing, so calls
+     * can be left in production code.
+     * */
+    void ResetStats() const;
+    void MarkFrame() const;
+    void PrintStats() const;
+    /* Use buffer instead of the driver owned pool (GC9A01_CHUNK_ROWS rows) as conversion scratch. CS stays asserted
+     * for the whole image and the two halves of the buffer are used ping-pong (convert one, DMA the other), so the
+     * chunk size only trades RAM for the number of DMA hand-offs.
+     *
+     * @param buffer word aligned, at least 48 bytes (two chunks of 8 pixels at 18 bits). nullptr goes back to the pool.
+     * */
+    void SetScratchBuffer(unsigned char buffer[], size_t bufferSize);
+    /* Sends a buffer that is already packed in the panel format (see GC9A01Kernels for the wire layouts) straight
+     * to MemoryWrite, without conversion or copy.
+     *
+     * @param pf the format the buffer is packed in, it has to match the current COLMOD setting
+     * @return false (and nothing is sent) when pf does not match the panel format
+     * */
+    bool BlitNative(const unsigned char pixels[], unsigned short x0, unsigned short y0, unsigned short w, unsigned short h, PixelFormat pf) const;
+    /* Non-blocking FillImage. The image is converted into out (GetImageBufferSize(w, h) bytes), the address window
+     * and MemoryWrite command are sent and the payload is handed to DMA. CS is released from the completion IRQ,
+     * after which callback(context) is called (from IRQ context on the RP2040).
+     *
+     * @note out must stay untouched until the transfer completes, see IsBusy() / WaitIdle().
+     * */
+    void FillImageAsync(const unsigned char image[], unsigned char out[], unsigned short x0, unsigned short y0, unsigned short w, unsigned short h,
+                        TransferCompleteCallback callback = nullptr, void* context = nullptr) const;
+    /* Non-blocking FillArea. The color is converted once and DMA repeats it over the whole window, nothing
+     * is buffered whatever the size of the area.
+     * */
+    void FillAreaAsync(unsigned char r, unsigned char g, unsigned char b, unsigned short x0, unsigned short y0, unsigned short w, unsigned short h,
+                       TransferCompleteCallback callback = nullptr, void* context = nullptr) const;
+    // True while an asynchronous transfer owns the bus
+    bool IsBusy() const;
+    // Block until the asynchronous transfer in flight (if any) has completed
+    void WaitIdle() const;
+    // Size of the converted image for the current pixel format, i.e. the size of the out buffer of FillImageAsync
+    size_t GetImageBufferSize(unsigned short w, unsigned short h) const;
     inline void HardwareReset() const {
         // TODO: Fix HW reset issue
-        gpio_put(this->rst_pin, OFF);
-        sleep_ms(120);
-        gpio_put(this->rst_pin, ON);
+        GC9A01HAL::PinPut(this->rst_pin, OFF);
+        GC9A01HAL::SleepMs(120);
+        GC9A01HAL::PinPut(this->rst_pin, ON);
+        this->InvalidateAfterReset();
     }
     /* This command causes the LCD module to enter the minimum power consumption mode. In this mode e.g. the DC/DC converter
      * is stopped, Internal oscillator is stopped, and panel scanning is stopped Out Blank STOP MCU interface and memory are
@@ -265,7 +574,7 @@ public:
      */
     inline void Sleep() const {
         this->WriteCycleSequence(RegulativeCommandSet::EnterSleepMode, nullptr, 0);
-        sleep_ms(5);
+        GC9A01HAL::SleepMs(5);
     }
     /* This command turns off sleep mode. the DC/DC converter is enabled, Internal oscillator is started, and panel scanning is started.
      *
@@ -332,11 +641,11 @@ public:
      * 
      * @note During Sleep In Mode with Tearing Effect Line On, Tearing Effect Output pin will be active Low.
      *
-     * @param hasVandHInfo When true, the Tearing Effect Output line consists of V-Blanking information only. When false, the Tearing Effect Output Line consists of both V-Blanking and H-Blanking information.
+     * @param hasVandHInfo When false, the Tearing Effect Output line consists of V-Blanking information only. When true, the Tearing Effect Output Line consists of both V-Blanking and H-Blanking information.
      * */
     inline void TearingEffectOn(bool hasVandHInfo) const {
         unsigned char data = (hasVandHInfo ? 0x01U : 0x00U);
-        this->WriteCycleSequence(RegulativeCommandSet::TearingEffectLineOFF, &data, 1U);
+        this->WriteCycleSequence(RegulativeCommandSet::TearingEffectLineON, &data, 1U);
     }
 
     /* This command is used together with Vertical Scrolling Definition (33h). These two commands
@@ -385,7 +694,7 @@ public:
         unsigned char data[2] = {0U};
         data[0] = lineAddress >> 8U;
         data[1] = lineAddress & 0xFFU;
-        this->WriteCycleSequence(RegulativeCommandSet::VerticalScrollingStartAddress, data, 2U);
+        this->WriteCycleSequence(RegulativeCommandSet::SetTearScanline, data, 2U);
     }
     /* This command is used to adjust the brightness value of the display.
      * It should be checked what is the relationship between this written value and output brightness of the display.
@@ -434,7 +743,7 @@ public:
      * */
     inline void SetDisplayFunctionControl(unsigned char ctrlOptions) const {
         unsigned char data[2] = { 0U };
-        data[2] = ctrlOptions;
+        data[1] = ctrlOptions;
         this->WriteCycleSequence(ExtendedCommandSet::DisplayFunctionControl, data, 2U);
     }
     /* @note During Sleep In Mode with Tearing Effect Line On, Tearing Effect Output pin will be active Low.
@@ -532,4 +841,23 @@ public:
     void CheckerboardTest() const;
 };
 
+/* Holds CS for its lifetime:
+ *
+ *     {
+ *         GC9A01Transaction transaction(display);
+ *         display.SetBrightness(0x80U);
+ *         display.FillArea(...);
+ *     }
+ * */
+class GC9A01Transaction
+{
+private:
+    const GC9A01& display;
+public:
+    explicit GC9A01Transaction(const GC9A01& display) : display(display) { this->display.BeginTransaction(); }
+    ~GC9A01Transaction() { this->display.EndTransaction(); }
+    GC9A01Transaction(const GC9A01Transaction&) = delete;
+    GC9A01Transaction& operator=(const GC9A01Transaction&) = delete;
+};
+
 #endif
@@ -0,0 +1,90 @@
+#include <string.h>
+#include "GC9A01_BandRenderer.hpp"
+
+GC9A01Band::GC9A01Band(unsigned char pixels[], unsigned short x0, unsigned short y0, unsigned short width, unsigned short rows)
+ : pixels(pixels), x0(x0), y0(y0), width(width), rows(rows) { }
+
+bool GC9A01Band::Clip(unsigned short* x, unsigned short* y, unsigned short* w, unsigned short* h) const {
+    if (!this->Intersects(*x, *y, *w, *h)) {
+        return false;
+    }
+    const unsigned short left = (*x > this->x0) ? *x : this->x0;
+    const unsigned short top = (*y > this->y0) ? *y : this->y0;
+    const unsigned short right = ((*x + *w) < (this->x0 + this->width)) ? (*x + *w) : (this->x0 + this->width);
+    const unsigned short bottom = ((*y + *h) < (this->y0 + this->rows)) ? (*y + *h) : (this->y0 + this->rows);
+    *x = left;
+    *y = top;
+    *w = right - left;
+    *h = bottom - top;
+    return true;
+}
+
+void GC9A01Band::Fill(unsigned char r, unsigned char g, unsigned char b) {
+    this->FillRect(this->x0, this->y0, this->width, this->rows, r, g, b);
+}
+
+void GC9A01Band::SetPixel(unsigned short x, unsigned short y, unsigned char r, unsigned char g, unsigned char b) {
+    if (this->Intersects(x, y, 1U, 1U)) {
+        unsigned char* const pixel = &this->GetRow(y)[(x - this->x0) * RGB_COUNT];
+        pixel[0] = r;
+        pixel[1] = g;
+        pixel[2] = b;
+    }
+}
+
+void GC9A01Band::FillRect(unsigned short x, unsigned short y, unsigned short w, unsigned short h, unsigned char r, unsigned char g, unsigned char b) {
+    if (!this->Clip(&x, &y, &w, &h)) {
+        return;
+    }
+    // First row pixel by pixel, the others are copies of it
+    unsigned char* const first = &this->GetRow(y)[(x - this->x0) * RGB_COUNT];
+    for (unsigned short i = 0U; i < w; ++i) {
+        first[i * RGB_COUNT] = r;
+        first[i * RGB_COUNT + 1U] = g;
+        first[i * RGB_COUNT + 2U] = b;
+    }
+    for (unsigned short row = 1U; row < h; ++row) {
+        memcpy(first + row * this->width * RGB_COUNT, first, w * RGB_COUNT);
+    }
+}
+
+void GC9A01Band::DrawImage(const unsigned char image[], unsigned short x, unsigned short y, unsigned short w, unsigned short h) {
+    unsigned short clippedX = x;
+    unsigned short clippedY = y;
+    unsigned short clippedW = w;
+    unsigned short clippedH = h;
+    if (!this->Clip(&clippedX, &clippedY, &clippedW, &clippedH)) {
+        return;
+    }
+    for (unsigned short row = clippedY; row < (clippedY + clippedH); ++row) {
+        const unsigned char* const source = &image[((row - y) * w + (clippedX - x)) * RGB_COUNT];
+        memcpy(&this->GetRow(row)[(clippedX - this->x0) * RGB_COUNT], source, clippedW * RGB_COUNT);
+    }
+}
+
+GC9A01BandRenderer::GC9A01BandRenderer(const GC9A01& display, unsigned char buffer[], size_t bufferSize)
+ : display(display), buffer(buffer), bufferSize(bufferSize), background{0U, 0U, 0U} { }
+
+void GC9A01BandRenderer::SetBackground(unsigned char r, unsigned char g, unsigned char b) {
+    this->background[0] = r;
+    this->background[1] = g;
+    this->background[2] = b;
+}
+
+void GC9A01BandRenderer::Render(RenderCallback callback, void* context, unsigned short x0, unsigned short y0, unsigned short w, unsigned short h) const {
+    const unsigned short bandRows = this->GetBandRows(w);
+    if (0U == bandRows) {
+        // Not even one row fits
+        return;
+    }
+
+    for (unsigned short y = y0; y < (y0 + h); y += bandRows) {
+        const unsigned short rows = ((y0 + h - y) < bandRows) ? (y0 + h - y) : bandRows;
+        GC9A01Band band(this->buffer, x0, y, w, rows);
+
+        band.Fill(this->background[0], this->background[1], this->background[2]);
+        callback(context, band);
+        // Blocks until the band is converted and sent, the buffer is then free for the next one
+        this->display.FillImage(this->buffer, x0, y, w, rows);
+    }
+}
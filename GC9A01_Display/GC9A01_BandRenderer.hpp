@@ -0,0 +1,65 @@
+#ifndef GC9A01_BAND_RENDERER_HPP
+#define GC9A01_BAND_RENDERER_HPP
+
+#include "GC9A01.hpp"
+
+/* A horizontal slice of the screen being rendered: rows [y0, y0 + rows) of the columns [x0, x0 + width), as RGB888.
+ * Drawing calls take screen coordinates and are clipped to the band, so a scene can be drawn the same way
+ * whatever band it lands in.
+ * */
+class GC9A01Band
+{
+private:
+    unsigned char* pixels;
+    unsigned short x0;
+    unsigned short y0;
+    unsigned short width;
+    unsigned short rows;
+    // Clips x, y, w, h to the band, false when nothing is left
+    bool Clip(unsigned short* x, unsigned short* y, unsigned short* w, unsigned short* h) const;
+public:
+    GC9A01Band(unsigned char pixels[], unsigned short x0, unsigned short y0, unsigned short width, unsigned short rows);
+    inline unsigned short GetX0() const { return this->x0; }
+    inline unsigned short GetY0() const { return this->y0; }
+    inline unsigned short GetWidth() const { return this->width; }
+    inline unsigned short GetRows() const { return this->rows; }
+    // RGB888 pixels of screen row y, which has to be inside the band
+    inline unsigned char* GetRow(unsigned short y) { return &this->pixels[(y - this->y0) * this->width * RGB_COUNT]; }
+    // True when the screen area x, y, w, h overlaps the band, lets a scene skip what is not in it
+    inline bool Intersects(unsigned short x, unsigned short y, unsigned short w, unsigned short h) const {
+        return (x < (this->x0 + this->width)) && ((x + w) > this->x0) && (y < (this->y0 + this->rows)) && ((y + h) > this->y0);
+    }
+    void Fill(unsigned char r, unsigned char g, unsigned char b);
+    void SetPixel(unsigned short x, unsigned short y, unsigned char r, unsigned char g, unsigned char b);
+    void FillRect(unsigned short x, unsigned short y, unsigned short w, unsigned short h, unsigned char r, unsigned char g, unsigned char b);
+    // RGB888 image of w x h pixels placed at x, y
+    void DrawImage(const unsigned char image[], unsigned short x, unsigned short y, unsigned short w, unsigned short h);
+};
+
+/* Renders a screen area band by band through one small RGB888 buffer: the scene callback draws into the band,
+ * the band is sent with FillImage (converted to the panel format on the way) and the buffer is reused for the
+ * next rows. Consecutive bands continue the same memory write (see WriteMemoryContinue), so the panel gets one
+ * tear free top to bottom pass while the RAM needed is only bufferSize, e.g. 240 x 8 rows = 5.6 KB.
+ * */
+class GC9A01BandRenderer
+{
+public:
+    // Draws everything of the scene that falls into band, the band is cleared to the background color first
+    typedef void (*RenderCallback)(void* context, GC9A01Band& band);
+private:
+    const GC9A01& display;
+    unsigned char* buffer;
+    size_t bufferSize;
+    unsigned char background[RGB_COUNT];
+public:
+    // @param buffer at least w * RGB_COUNT bytes for the widest area rendered, word aligned for the fast conversion path
+    GC9A01BandRenderer(const GC9A01& display, unsigned char buffer[], size_t bufferSize);
+    void SetBackground(unsigned char r, unsigned char g, unsigned char b);
+    // Rows per band for an area w pixels wide
+    inline unsigned short GetBandRows(unsigned short w) const { return this->bufferSize / (w * RGB_COUNT); }
+    // Renders the area x0, y0, w, h (the full screen by default)
+    void Render(RenderCallback callback, void* context, unsigned short x0 = 0U, unsigned short y0 = 0U,
+                unsigned short w = MAX_WIDTH, unsigned short h = MAX_HEIGHT) const;
+};
+
+#endif
@@ -0,0 +1,601 @@
+#include <stdio.h>
+#include "GC9A01_Benchmark.hpp"
+#include "GC9A01_PixelKernels.hpp"
+#include "GC9A01_FrameBuffer.hpp"
+#include "GC9A01_Primitives.hpp"
+#include "GC9A01_Gauge.hpp"
+#include "GC9A01_DisplayList.hpp"
+#include "GC9A01_Compositor.hpp"
+#include "GC9A01_FrameScheduler.hpp"
+#include "GC9A01_Round.hpp"
+
+namespace {
+    constexpr size_t BAND_PIXELS = MAX_WIDTH * 8U;
+
+    alignas(4) unsigned char band[BAND_PIXELS * RGB_COUNT];
+    alignas(4) unsigned char out[BAND_PIXELS * RGB_COUNT];
+
+    const char* const FORMAT_NAMES[] = {"12bpp", "16bpp", "18bpp"};
+
+    void FillBand() {
+        unsigned int seed = 0x12345678U;
+        for (size_t i = 0U; i < sizeof(band); ++i) {
+            seed = seed * 1103515245U + 12345U;
+            band[i] = seed >> 24U;
+        }
+    }
+
+    // Diagonal gradient computed per span, the background of the compositor benchmark
+    void Gradient(void* context, unsigned short x, unsigned short y, unsigned short w, unsigned char rgb[]) {
+        (void)context;
+        for (unsigned short i = 0U; i < w; ++i) {
+            rgb[i * RGB_COUNT] = x + i;
+            rgb[i * RGB_COUNT + 1U] = y;
+            rgb[i * RGB_COUNT + 2U] = (x + i + y) / 2U;
+        }
+    }
+
+    // HandlePixels as it was before the kernels, kept as the baseline
+    void LegacyHandlePixels(PixelFormat pf, bool is_rgb, const unsigned char originalPixels[], size_t * const originalIndex, unsigned char out[], size_t * const outIndex) {
+        const unsigned char GREEN_SHIFT = 0U;
+        const unsigned char BLUE_SHIFT = (is_rgb ? 1U : 2U);
+        const unsigned char RED_SHIFT = (is_rgb ? 2U : 1U);
+
+        switch (pf)
+        {
+        case PF12BitsPerPixel:
+        {
+            const unsigned char red1 = originalPixels[*originalIndex + RED_SHIFT];
+            const unsigned char green1 = originalPixels[*originalIndex + GREEN_SHIFT];
+            const unsigned char blue1 = originalPixels[*originalIndex + BLUE_SHIFT];
+            const unsigned char red2 = originalPixels[*originalIndex + 3U + RED_SHIFT];
+            const unsigned char green2 = originalPixels[*originalIndex + 3U + GREEN_SHIFT];
+            const unsigned char blue2 = originalPixels[*originalIndex + 3U + BLUE_SHIFT];
+            *originalIndex += 6U;
+            if (is_rgb) {
+                out[*outIndex] = (green1 & 0xF0U) | ((blue1 & 0xF0U) >> 4U);
+                ++*outIndex;
+                out[*outIndex] = (red1 & 0xF0U) | ((green2 & 0xF0U) >> 4U);
+                ++*outIndex;
+                out[*outIndex] = (blue2 & 0xF0U) | ((red2 & 0xF0U) >> 4U);
+                ++*outIndex;
+            } else {
+                out[*outIndex] = (green1 & 0xF0U) | ((red1 & 0xF0U) >> 4U);
+                ++*outIndex;
+                out[*outIndex] = (blue1 & 0xF0U) | ((green2 & 0xF0U) >> 4U);
+                ++*outIndex;
+                out[*outIndex] = (red2 & 0xF0U) | ((blue2 & 0xF0U) >> 4U);
+                ++*outIndex;
+            }
+            break;
+        }
+        case PF16BitsPerPixel:
+        {
+            unsigned char red = originalPixels[*originalIndex + RED_SHIFT];
+            unsigned char green = originalPixels[*originalIndex + GREEN_SHIFT];
+            unsigned char blue = originalPixels[*originalIndex + BLUE_SHIFT];
+            *originalIndex += 3U;
+            if (is_rgb) {
+                out[*outIndex] = (green >> 2U) | (blue >> 6U);
+                ++*outIndex;
+                out[*outIndex] = ((blue >> 3U) & 0x03U) | (red >> 3U);
+                ++*outIndex;
+            } else {
+                out[*outIndex] = (green >> 2U) | (red >> 6U);
+                ++*outIndex;
+                out[*outIndex] = ((red >> 3U) & 0x03U) | (blue >> 3U);
+                ++*outIndex;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    void LegacyReMap(PixelFormat pf, bool is_rgb, const unsigned char originalPixels[], const size_t pixelCount, unsigned char out[]) {
+        size_t outIndex = 0U;
+        const size_t loopsCount = pixelCount * 3;
+
+        for (size_t i = 0U; i < loopsCount; ) {
+            LegacyHandlePixels(pf, is_rgb, originalPixels, &i, out, &outIndex);
+        }
+    }
+
+    // One line of the Suite output
+    typedef struct {
+        const char* name;
+        unsigned short w;
+        unsigned short h;
+        // 0: FillArea, 1: FillImage, 2: full screen FillImage in bands, 3: conversion only
+        unsigned char kind;
+    } SuiteCase;
+
+    const SuiteCase SUITE_CASES[] = {
+        {"fill_full", MAX_WIDTH, MAX_HEIGHT, 0U},
+        {"fill_rect", 8U, 8U, 0U},
+        {"fill_rect", 32U, 32U, 0U},
+        {"fill_rect", 120U, 120U, 0U},
+        {"image", 8U, 8U, 1U},
+        {"image", 32U, 32U, 1U},
+        {"image", 80U, 24U, 1U},
+        {"image", MAX_WIDTH, 8U, 1U},
+        {"image_full", MAX_WIDTH, MAX_HEIGHT, 2U},
+        {"convert", MAX_WIDTH, 8U, 3U},
+    };
+
+    double MegaPixelsPerSecond(unsigned long long pixels, unsigned long long elapsedUs) {
+        return (0U == elapsedUs) ? 0.0 : (static_cast<double>(pixels) / static_cast<double>(elapsedUs));
+    }
+}
+
+namespace GC9A01Benchmark {
+    void PixelKernels(unsigned int iterations) {
+        const unsigned long long pixels = static_cast<unsigned long long>(BAND_PIXELS) * iterations;
+        FillBand();
+
+        printf("format  order  legacy Mpx/s  kernel Mpx/s  dither Mpx/s\n");
+        for (int pf = PF12BitsPerPixel; pf <= PF18BitsPerPixel; ++pf) {
+            for (int order = ColorOrderRGB; order <= ColorOrderBGR; ++order) {
+                const PixelFormat format = static_cast<PixelFormat>(pf);
+                const bool is_rgb = (ColorOrderRGB == order);
+                double legacy = 0.0;
+
+                // The former 18 bit branch never advanced the source index, it cannot be timed
+                if (PF18BitsPerPixel != format) {
+                    const unsigned long long start = GC9A01HAL::TimeUs();
+                    for (unsigned int i = 0U; i < iterations; ++i) {
+                        LegacyReMap(format, is_rgb, band, BAND_PIXELS, out);
+                    }
+                    legacy = MegaPixelsPerSecond(pixels, GC9A01HAL::TimeUs() - start);
+                }
+
+                const unsigned long long start = GC9A01HAL::TimeUs();
+                const GC9A01Kernels::ConvertFunction convert = GC9A01Kernels::Select(format, static_cast<ColorOrder>(order));
+                for (unsigned int i = 0U; i < iterations; ++i) {
+                    convert(band, BAND_PIXELS, out);
+                }
+                const double kernel = MegaPixelsPerSecond(pixels, GC9A01HAL::TimeUs() - start);
+
+                const unsigned long long ditherStart = GC9A01HAL::TimeUs();
+                const GC9A01Kernels::DitherFunction ditherConvert = GC9A01Kernels::SelectDithered(format, static_cast<ColorOrder>(order));
+                for (unsigned int i = 0U; i < iterations; ++i) {
+                    GC9A01Kernels::Cursor cursor = {0U, 0U, 0U, MAX_WIDTH - 1U};
+                    ditherConvert(band, BAND_PIXELS, out, &cursor);
+                }
+                const double dither = MegaPixelsPerSecond(pixels, GC9A01HAL::TimeUs() - ditherStart);
+
+                if (PF18BitsPerPixel != format) {
+                    printf("%-6s  %-5s  %12.2f  %12.2f  %12.2f\n", FORMAT_NAMES[pf], (is_rgb ? "RGB" : "BGR"), legacy, kernel, dither);
+                } else {
+                    printf("%-6s  %-5s  %12s  %12.2f  %12.2f\n", FORMAT_NAMES[pf], (is_rgb ? "RGB" : "BGR"), "n/a", kernel, dither);
+                }
+            }
+        }
+    }
+
+    void ColorLuts(unsigned int iterations) {
+        static constexpr GC9A01Kernels::ColorLut LUTS[] = {
+            GC9A01Kernels::ColorLut(PF12BitsPerPixel, ColorOrderRGB, 2.2),
+            GC9A01Kernels::ColorLut(PF16BitsPerPixel, ColorOrderRGB, 2.2),
+            GC9A01Kernels::ColorLut(PF18BitsPerPixel, ColorOrderRGB, 2.2),
+        };
+        const unsigned long long pixels = static_cast<unsigned long long>(BAND_PIXELS) * iterations;
+        FillBand();
+
+        printf("format  shift/mask Mpx/s  gamma lut Mpx/s\n");
+        for (int pf = PF12BitsPerPixel; pf <= PF18BitsPerPixel; ++pf) {
+            const GC9A01Kernels::ConvertFunction convert = GC9A01Kernels::Select(static_cast<PixelFormat>(pf), ColorOrderRGB);
+            unsigned long long start = GC9A01HAL::TimeUs();
+            for (unsigned int i = 0U; i < iterations; ++i) {
+                convert(band, BAND_PIXELS, out);
+            }
+            const double shiftMask = MegaPixelsPerSecond(pixels, GC9A01HAL::TimeUs() - start);
+
+            start = GC9A01HAL::TimeUs();
+            for (unsigned int i = 0U; i < iterations; ++i) {
+                GC9A01Kernels::ConvertWithLut(LUTS[pf], band, BAND_PIXELS, out);
+            }
+            const double lut = MegaPixelsPerSecond(pixels, GC9A01HAL::TimeUs() - start);
+
+            printf("%-6s  %16.2f  %15.2f\n", FORMAT_NAMES[pf], shiftMask, lut);
+        }
+    }
+
+    void FrameBufferUpdates(const GC9A01& display, unsigned short pixels[], unsigned int frames) {
+        GC9A01FrameBuffer frameBuffer(display, pixels);
+        // Bytes are counted with the 11 bytes of ColumnAddressSet, RowAddressSet and MemoryWrite per rectangle
+        const unsigned long long fullBytes = display.GetImageBufferSize(MAX_WIDTH, MAX_HEIGHT) + 11U;
+
+        frameBuffer.Clear(0U, 0U, 0U);
+        frameBuffer.Flush();
+
+        printf("update              rects/frame  bytes/frame  vs full  us/frame\n");
+        for (unsigned int scenario = 0U; scenario < 5U; ++scenario) {
+            static const char* const SCENARIO_NAMES[] = {"full redraw", "clock digit", "clock h:m:s", "progress bar", "16 sprites"};
+            unsigned long long rects = 0U;
+            unsigned long long bytes = 0U;
+            const unsigned long long start = GC9A01HAL::TimeUs();
+
+            for (unsigned int frame = 0U; frame < frames; ++frame) {
+                const unsigned char shade = (frame * 37U) & 0xFFU;
+                switch (scenario)
+                {
+                case 0U:
+                    frameBuffer.Clear(shade, 0U, 255U - shade);
+                    break;
+                case 1U:
+                    // One 7-segment style digit changes
+                    frameBuffer.FillRect(150U, 100U, 24U, 40U, 0U, 0U, 0U);
+                    frameBuffer.FillRect(152U + (frame % 3U) * 4U, 102U, 4U, 36U, 255U, 255U, 255U);
+                    break;
+                case 2U:
+                    // Seconds every frame, minutes and hours now and then, far apart
+                    frameBuffer.FillRect(170U, 100U, 40U, 40U, shade, shade, shade);
+                    if (0U == (frame % 10U)) {
+                        frameBuffer.FillRect(100U, 100U, 40U, 40U, shade, 0U, 0U);
+                    }
+                    if (0U == (frame % 30U)) {
+                        frameBuffer.FillRect(30U, 100U, 40U, 40U, 0U, shade, 0U);
+                    }
+                    break;
+                case 3U:
+                    frameBuffer.FillRect(40U + ((frame * 3U) % 160U), 200U, 3U, 10U, 0U, 255U, 0U);
+                    break;
+                default:
+                    // Sprites scattered over the screen, more than the dirty list holds
+                    for (unsigned int sprite = 0U; sprite < 16U; ++sprite) {
+                        const unsigned short x = (sprite * 53U + frame * 5U) % (MAX_WIDTH - 8U);
+                        const unsigned short y = (sprite * 97U + frame * 3U) % (MAX_HEIGHT - 8U);
+                        frameBuffer.FillRect(x, y, 8U, 8U, shade, 255U, sprite * 16U);
+                    }
+                    break;
+                }
+                frameBuffer.Flush();
+                rects += frameBuffer.GetLastFlushRects();
+                bytes += frameBuffer.GetLastFlushBytes() + frameBuffer.GetLastFlushRects() * 11U;
+            }
+
+            const double us = static_cast<double>(GC9A01HAL::TimeUs() - start) / frames;
+            printf("%-18s  %11.2f  %11llu  %6.2f%%  %8.1f\n", SCENARIO_NAMES[scenario], static_cast<double>(rects) / frames, bytes / frames,
+                   (100.0 * bytes) / (static_cast<double>(fullBytes) * frames), us);
+        }
+    }
+
+    void Primitives(const GC9A01& display, unsigned short pixels[], unsigned int frames) {
+        static const char* const SHAPE_NAMES[] = {"ring r110", "gauge arc t14", "disc r100", "16 needles"};
+        GC9A01FrameBuffer frameBuffer(display, pixels);
+        GC9A01Primitives primitives(display);
+
+        printf("shape          pixels  spans  spans us/frame  framebuffer us/frame  per pixel us/frame\n");
+        for (unsigned int shape = 0U; shape < 4U; ++shape) {
+            double us[3] = {0.0, 0.0, 0.0};
+            size_t spans = 0U;
+            size_t pixelCount = 0U;
+
+            for (unsigned int path = 0U; path < 3U; ++path) {
+                // The per pixel path sends what the framebuffer path left in RAM, one 1x1 window per lit pixel
+                primitives.SetFrameBuffer((0U == path) ? nullptr : &frameBuffer);
+                if (1U == path) {
+                    frameBuffer.Clear(0U, 0U, 0U);
+                    frameBuffer.Flush();
+                }
+                primitives.ResetSpanCount();
+                const unsigned long long start = GC9A01HAL::TimeUs();
+                for (unsigned int frame = 0U; frame < frames; ++frame) {
+                    primitives.SetColor(255U, (frame * 37U) & 0xFFU, 0U);
+                    if (2U == path) {
+                        for (size_t i = 0U; i < (MAX_WIDTH * MAX_HEIGHT); ++i) {
+                            if (0U != pixels[i]) {
+                                display.FillArea(255U, (frame * 37U) & 0xFFU, 0U, i % MAX_WIDTH, i / MAX_WIDTH, 1U, 1U);
+                            }
+                        }
+                        continue;
+                    }
+                    switch (shape)
+                    {
+                    case 0U:
+                        primitives.DrawCircle(120, 120, 110);
+                        break;
+                    case 1U:
+                        primitives.DrawArc(120, 120, 110, 14, 225, 135);
+                        break;
+                    case 2U:
+                        primitives.FillCircle(120, 120, 100);
+                        break;
+                    default:
+                        for (int needle = 0; needle < 16; ++needle) {
+                            static const short ENDS[] = {120, 160, 198, 227, 235, 227, 198, 160, 120, 80, 42, 13, 5, 13, 42, 80};
+                            primitives.DrawLine(120, 120, ENDS[needle], ENDS[(needle + 4) % 16]);
+                        }
+                        break;
+                    }
+                    if (1U == path) {
+                        frameBuffer.Flush();
+                    }
+                }
+                us[path] = static_cast<double>(GC9A01HAL::TimeUs() - start) / frames;
+                if (0U == path) {
+                    spans = primitives.GetSpanCount() / frames;
+                }
+            }
+            for (size_t i = 0U; i < (MAX_WIDTH * MAX_HEIGHT); ++i) {
+                pixelCount += (0U != pixels[i]) ? 1U : 0U;
+            }
+
+            printf("%-13s  %6zu  %5zu  %14.1f  %20.1f  %18.1f\n", SHAPE_NAMES[shape], pixelCount, spans, us[0], us[1], us[2]);
+        }
+    }
+
+    void Gauge(const GC9A01& display, unsigned int frames) {
+        const PixelFormat previous = display.GetPixelFormat();
+        display.SetPixelFormat(PF16BitsPerPixel);
+        GC9A01Gauge gauge(display, band, sizeof(band));
+
+        display.FillScreen(0U, 0U, 0U);
+        unsigned long long start = GC9A01HAL::TimeUs();
+        gauge.Draw(0);
+        const unsigned long long drawUs = GC9A01HAL::TimeUs() - start;
+
+        printf("update          pixels  windows  bytes  us/frame    fps\n");
+        printf("%-14s  %6zu  %7zu  %5zu  %8llu  %5.1f\n", "full dial", gauge.GetLastPixels(), gauge.GetLastWindows(),
+               display.GetImageBufferSize(gauge.GetLastPixels(), 1U), drawUs, 1000000.0 / drawUs);
+
+        // One unit per frame up and down the scale, then jumps across it
+        for (unsigned int test = 0U; test < 2U; ++test) {
+            unsigned long long pixels = 0U;
+            unsigned long long windows = 0U;
+            start = GC9A01HAL::TimeUs();
+            for (unsigned int frame = 0U; frame < frames; ++frame) {
+                const int step = frame % 200U;
+                const int value = (0U == test) ? ((step <= 100) ? step : (200 - step)) : static_cast<int>((frame * 37U) % 101U);
+                gauge.MoveTo(value);
+                pixels += gauge.GetLastPixels();
+                windows += gauge.GetLastWindows();
+            }
+            const double us = static_cast<double>(GC9A01HAL::TimeUs() - start) / frames;
+            printf("%-14s  %6llu  %7.1f  %5zu  %8.1f  %5.1f\n", ((0U == test) ? "needle sweep" : "needle jumps"), pixels / frames,
+                   static_cast<double>(windows) / frames, display.GetImageBufferSize(pixels / frames, 1U), us, 1000000.0 / us);
+        }
+        display.SetPixelFormat(previous);
+    }
+
+    void DisplayList(const GC9A01& display, unsigned int frames) {
+        GC9A01DisplayList list(display, band, sizeof(band));
+        char text[] = "00:00";
+        list.SetBackground(0U, 0U, 32U);
+        list.AddRect(60U, 60U, 120U, 120U, 0U, 0U, 96U);
+        const size_t arc = list.AddArc(120U, 120U, 112U, 6U, 0, 0, 0U, 200U, 80U);
+        const size_t clock = list.AddText(91U, 113U, text, 255U, 255U, 255U, 2U);
+        const size_t marker = list.AddRect(0U, 0U, 8U, 8U, 255U, 160U, 0U);
+        list.Render();
+
+        printf("render        rects  pixels  us/frame    fps\n");
+        for (unsigned int test = 0U; test < 2U; ++test) {
+            unsigned long long rects = 0U;
+            unsigned long long pixels = 0U;
+            const unsigned long long start = GC9A01HAL::TimeUs();
+            for (unsigned int frame = 0U; frame < frames; ++frame) {
+                text[3] = '0' + ((frame / 10U) % 6U);
+                text[4] = '0' + (frame % 10U);
+                list.Invalidate(clock);
+                list.SetArcAngles(arc, 0, static_cast<short>((frame * 6U) % 360U));
+                list.SetPosition(marker, 60U + ((frame * 4U) % 112U), 150U);
+                if (1U == test) {
+                    list.InvalidateAll();
+                }
+                list.Render();
+                rects += list.GetLastRects();
+                pixels += list.GetLastPixels();
+            }
+            const double us = static_cast<double>(GC9A01HAL::TimeUs() - start) / frames;
+            printf("%-12s  %5.1f  %6llu  %8.1f  %5.1f\n", ((0U == test) ? "incremental" : "full"), static_cast<double>(rects) / frames,
+                   pixels / frames, us, 1000000.0 / us);
+        }
+    }
+
+    void Compositor(const GC9A01& display, unsigned int frames) {
+        static const char* const LAYER_NAMES[] = {"gradient", "+ panel", "+ sprite", "+ text"};
+        FillBand();
+        GC9A01Compositor compositor(display);
+
+        printf("layers      us/frame    fps\n");
+        for (unsigned int layers = 0U; layers < 4U; ++layers) {
+            switch (layers)
+            {
+            case 0U:
+                compositor.AddSource(0U, 0U, MAX_WIDTH, MAX_HEIGHT, &Gradient, nullptr);
+                break;
+            case 1U:
+                compositor.SetAlpha(compositor.AddSolid(40U, 60U, 160U, 120U, 0U, 0U, 0U), 160U);
+                break;
+            case 2U:
+                // The random band as a 60x32 sprite, about one pixel in 256 matches the key
+                compositor.AddSprite(90U, 70U, 60U, 32U, band, 0U, 0U, 0U);
+                break;
+            default:
+                compositor.AddGlyphs(66U, 130U, "12:34:56", 255U, 255U, 255U, 3U);
+                break;
+            }
+            const unsigned long long start = GC9A01HAL::TimeUs();
+            for (unsigned int frame = 0U; frame < frames; ++frame) {
+                compositor.Render();
+            }
+            const double us = static_cast<double>(GC9A01HAL::TimeUs() - start) / frames;
+            printf("%-10s  %8.1f  %5.1f\n", LAYER_NAMES[layers], us, 1000000.0 / us);
+        }
+    }
+
+    void RoundClip(GC9A01& display, unsigned int frames) {
+        const bool wasRoundClip = display.GetRoundClip();
+        // Bytes are counted with the 11 bytes of ColumnAddressSet, RowAddressSet and MemoryWrite per window
+        const unsigned long long squareBytes = display.GetImageBufferSize(MAX_WIDTH, MAX_HEIGHT) + 11U;
+        unsigned long long roundBytes = 0U;
+        unsigned int roundWindows = 0U;
+        for (unsigned short y = 0U; y < MAX_HEIGHT; ) {
+            unsigned short left = 0U;
+            unsigned short count = 0U;
+            const unsigned short rows = GC9A01Round::GetRun(y, MAX_HEIGHT, 0U, MAX_WIDTH, &left, &count);
+            roundBytes += display.GetImageBufferSize(count, rows) + 11U;
+            ++roundWindows;
+            y += rows;
+        }
+
+        printf("write         clip    windows  bytes/frame  vs square  us/frame\n");
+        for (unsigned int test = 0U; test < 4U; ++test) {
+            const bool round = (0U != (test & 1U));
+            const unsigned long long bytes = round ? roundBytes : squareBytes;
+            display.SetRoundClip(round);
+
+            const unsigned long long start = GC9A01HAL::TimeUs();
+            for (unsigned int frame = 0U; frame < frames; ++frame) {
+                if (test < 2U) {
+                    const unsigned char shade = (frame * 37U) & 0xFFU;
+                    display.FillScreen(shade, 0U, 255U - shade);
+                } else {
+                    display.RainbowTest();
+                }
+            }
+            const double us = static_cast<double>(GC9A01HAL::TimeUs() - start) / frames;
+
+            printf("%-12s  %-6s  %7u  %11llu  %8.2f%%  %8.1f\n", ((test < 2U) ? "FillScreen" : "RainbowTest"), (round ? "round" : "square"),
+                   (round ? roundWindows : 1U), bytes, (100.0 * bytes) / squareBytes, us);
+        }
+        display.SetRoundClip(wasRoundClip);
+    }
+
+    void ColorDepth(const GC9A01& display, unsigned int frames) {
+        const PixelFormat previous = display.GetPixelFormat();
+        const unsigned short bandRows = BAND_PIXELS / MAX_WIDTH;
+        FillBand();
+
+        printf("format  bytes/frame  bytes/px  fill us/frame  image us/frame\n");
+        for (int pf = PF12BitsPerPixel; pf <= PF18BitsPerPixel; ++pf) {
+            const PixelFormat format = static_cast<PixelFormat>(pf);
+            display.SetPixelFormat(format);
+            const size_t bytes = display.GetImageBufferSize(MAX_WIDTH, MAX_HEIGHT);
+
+            unsigned long long start = GC9A01HAL::TimeUs();
+            for (unsigned int frame = 0U; frame < frames; ++frame) {
+                display.FillScreen((frame * 37U) & 0xFFU, 0U, 0xFFU);
+            }
+            const double fill = static_cast<double>(GC9A01HAL::TimeUs() - start) / frames;
+
+            start = GC9A01HAL::TimeUs();
+            for (unsigned int frame = 0U; frame < frames; ++frame) {
+                for (unsigned short y = 0U; y < MAX_HEIGHT; y += bandRows) {
+                    display.FillImage(band, 0U, y, MAX_WIDTH, bandRows);
+                }
+            }
+            const double image = static_cast<double>(GC9A01HAL::TimeUs() - start) / frames;
+
+            printf("%-6s  %11zu  %8.2f  %13.1f  %14.1f\n", FORMAT_NAMES[pf], bytes, static_cast<double>(bytes) / (MAX_WIDTH * MAX_HEIGHT),
+                   fill, image);
+        }
+        display.SetPixelFormat(previous);
+    }
+
+    void FramePacing(const GC9A01& display, unsigned char te_pin, unsigned int frames) {
+        static const unsigned short ROWS[] = {MAX_HEIGHT, 180U, 120U};
+        const PixelFormat previous = display.GetPixelFormat();
+        const unsigned short bandRows = BAND_PIXELS / MAX_WIDTH;
+        FillBand();
+        GC9A01FrameScheduler scheduler(display, te_pin);
+        scheduler.Start();
+
+        printf("format  rows  us/update  missed  worst slack us      fps\n");
+        for (int pf = PF12BitsPerPixel; pf <= PF16BitsPerPixel; ++pf) {
+            display.SetPixelFormat(static_cast<PixelFormat>(pf));
+            for (unsigned short rows : ROWS) {
+                scheduler.ResetStats();
+                unsigned long long busy = 0U;
+                const unsigned long long start = GC9A01HAL::TimeUs();
+                for (unsigned int frame = 0U; frame < frames; ++frame) {
+                    scheduler.BeginFrame();
+                    const unsigned long long update = GC9A01HAL::TimeUs();
+                    for (unsigned short y = 0U; y < rows; y += bandRows) {
+                        display.FillImage(band, 0U, y, MAX_WIDTH, bandRows);
+                    }
+                    scheduler.EndFrame();
+                    busy += GC9A01HAL::TimeUs() - update;
+                }
+                const double us = static_cast<double>(GC9A01HAL::TimeUs() - start) / frames;
+                const GC9A01FrameStats& stats = scheduler.GetStats();
+                printf("%-6s  %4u  %9llu  %6lu  %14lld  %7.1f\n", FORMAT_NAMES[pf], rows, busy / frames, stats.missed, stats.worstSlackUs,
+                       1000000.0 / us);
+            }
+        }
+        scheduler.Stop();
+        display.SetPixelFormat(previous);
+    }
+
+    void Suite(GC9A01& display, unsigned int frames) {
+#ifdef GC9A01_HOST
+        const char* const backend = "host";
+#else
+        const char* const backend = "rp2040";
+#endif
+        const PixelFormat previousFormat = display.GetPixelFormat();
+        const ColorOrder previousOrder = display.GetColorOrder();
+        FillBand();
+
+        printf("backend,case,format,order,w,h,ops,us_per_op,mpix_s,payload_bytes,bus_bytes\n");
+        for (int pf = PF12BitsPerPixel; pf <= PF18BitsPerPixel; ++pf) {
+            for (int order = ColorOrderRGB; order <= ColorOrderBGR; ++order) {
+                display.SetPixelFormat(static_cast<PixelFormat>(pf));
+                display.SetColorOrder(static_cast<ColorOrder>(order));
+                const GC9A01Kernels::ConvertFunction convert = GC9A01Kernels::Select(static_cast<PixelFormat>(pf), static_cast<ColorOrder>(order));
+
+                for (size_t c = 0U; c < (sizeof(SUITE_CASES) / sizeof(SUITE_CASES[0])); ++c) {
+                    const SuiteCase& test = SUITE_CASES[c];
+                    const size_t opPixels = test.w * test.h;
+                    const unsigned int ops = (frames * MAX_WIDTH * MAX_HEIGHT + opPixels - 1U) / opPixels;
+                    // Positions step through the screen so that most ops need a new window
+                    const unsigned short xRange = MAX_WIDTH - test.w + 1U;
+                    const unsigned short yRange = MAX_HEIGHT - test.h + 1U;
+
+                    display.ResetStats();
+                    const unsigned long long start = GC9A01HAL::TimeUs();
+                    for (unsigned int op = 0U; op < ops; ++op) {
+                        const unsigned short x = (op * 53U) % xRange;
+                        const unsigned short y = (op * 31U) % yRange;
+                        switch (test.kind)
+                        {
+                        case 0U:
+                            display.FillArea(op & 0xFFU, 0x80U, 0xFFU - (op & 0xFFU), x, y, test.w, test.h);
+                            break;
+                        case 1U:
+                            display.FillImage(band, x, y, test.w, test.h);
+                            break;
+                        case 2U:
+                            for (unsigned short row = 0U; row < MAX_HEIGHT; row += 8U) {
+                                display.FillImage(band, 0U, row, MAX_WIDTH, 8U);
+                            }
+                            break;
+                        default:
+                            convert(band, opPixels, out);
+                            break;
+                        }
+                    }
+                    const unsigned long long elapsed = GC9A01HAL::TimeUs() - start;
+
+                    printf("%s,%s,%s,%s,%u,%u,%u,%.3f,%.3f,%zu,", backend, test.name, FORMAT_NAMES[pf], ((ColorOrderRGB == order) ? "RGB" : "BGR"),
+                           test.w, test.h, ops, static_cast<double>(elapsed) / ops, MegaPixelsPerSecond(static_cast<unsigned long long>(opPixels) * ops, elapsed),
+                           ((3U == test.kind) ? 0U : display.GetImageBufferSize(test.w, test.h)));
+#ifdef GC9A01_STATS
+                    const GC9A01Stats stats = display.GetStats();
+                    unsigned long long busBytes = stats.parameterBytes + stats.pixelBytes;
+                    for (unsigned int command = 0U; command < 256U; ++command) {
+                        busBytes += stats.commandCounts[command];
+                    }
+                    printf("%.1f\n", static_cast<double>(busBytes) / ops);
+#else
+                    printf("\n");
+#endif
+                }
+            }
+        }
+        display.SetPixelFormat(previousFormat);
+        display.SetColorOrder(previousOrder);
+    }
+}
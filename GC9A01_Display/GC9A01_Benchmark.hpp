@@ -0,0 +1,68 @@
+#ifndef GC9A01_BENCHMARK_HPP
+#define GC9A01_BENCHMARK_HPP
+
+#include "GC9A01.hpp"
+
+/* Driver benchmarks. They only rely on the HAL clock and printf, so the same code runs on the RP2040 and on
+ * the host build (where bus time comes from the attached GC9A01Emulator).
+ * */
+namespace GC9A01Benchmark {
+    /* Converts a 240x8 RGB888 band `iterations` times with the former per pixel HandlePixels path, with the kernel
+     * GC9A01Kernels::Select picks and with its dithered counterpart, for every PixelFormat and color order, and
+     * prints Mpixel/s of each.
+     * */
+    void PixelKernels(unsigned int iterations = 2000U);
+    /* Converts the same band with the shift and mask kernels and through GC9A01Kernels::ColorLut tables (gamma 2.2,
+     * built by the compiler) for every PixelFormat, and prints Mpixel/s of both.
+     * */
+    void ColorLuts(unsigned int iterations = 2000U);
+    /* Drives a full screen GC9A01FrameBuffer (pixels: MAX_WIDTH * MAX_HEIGHT) on display through typical UI updates
+     * and prints, per frame, the rectangles and bytes flushed and the time taken, next to a full redraw.
+     * */
+    void FrameBufferUpdates(const GC9A01& display, unsigned short pixels[], unsigned int frames = 60U);
+    /* Draws gauge shapes (a ring, a thick 270 degree arc, a disc and a fan of lines) with GC9A01Primitives straight
+     * to the panel and into a full screen GC9A01FrameBuffer (pixels: MAX_WIDTH * MAX_HEIGHT) flushed every frame, and
+     * sends the same pixels one 1x1 FillArea each. Prints the pixels, spans and time per frame of each path.
+     * */
+    void Primitives(const GC9A01& display, unsigned short pixels[], unsigned int frames = 10U);
+    /* GC9A01Gauge at 16 bits per pixel: a full dial, then `frames` needle moves of one unit (of 100) per frame and
+     * `frames` jumps across the scale. Prints the pixels, windows, bytes and time per frame and the frame rate it
+     * allows. The pixel format of display is restored afterwards.
+     * */
+    void Gauge(const GC9A01& display, unsigned int frames = 120U);
+    /* GC9A01DisplayList with a clock face scene: a seconds text updated every frame, a progress arc and a marker
+     * moving around the screen. Prints the rectangles, pixels and time per frame of Render() next to a full redraw.
+     * */
+    void DisplayList(const GC9A01& display, unsigned int frames = 60U);
+    /* Full screen GC9A01Compositor renders with a growing stack of layers: a computed gradient, a translucent panel,
+     * a color keyed sprite and a line of text. Prints the time per frame and frame rate for each stack.
+     * */
+    void Compositor(const GC9A01& display, unsigned int frames = 10U);
+    /* Full screen FillScreen and RainbowTest with GC9A01::SetRoundClip off and on, prints the windows, bytes
+     * and time per frame of each. The round clip setting of display is restored afterwards.
+     * */
+    void RoundClip(GC9A01& display, unsigned int frames = 10U);
+    /* Full screen FillScreen and FillImage (a 240x8 band repeated down the screen) at 12, 16 and 18 bits per pixel,
+     * prints the bytes and time per frame of each. The pixel format of display is restored afterwards.
+     * */
+    void ColorDepth(const GC9A01& display, unsigned int frames = 10U);
+    /* Updates of 240, 180 and 120 rows (240x8 bands from the top) at 12 and 16 bits per pixel, each started by a
+     * GC9A01FrameScheduler on the TE edge of te_pin. Prints the time per update, the frames that missed their
+     * deadline, the worst slack and the frame rate. The pixel format of display is restored afterwards.
+     * */
+    void FramePacing(const GC9A01& display, unsigned char te_pin, unsigned int frames = 30U);
+    /* Fixed benchmark matrix for regression tracking, printed as CSV (one header line, one line per case):
+     *
+     *     backend,case,format,order,w,h,ops,us_per_op,mpix_s,payload_bytes,bus_bytes
+     *
+     * Every PixelFormat and color order runs: full screen fill, rectangle fills and FillImage of several sizes
+     * (at positions that move the window each time), a full screen FillImage sent as 240x8 bands and the bare
+     * conversion of a band. Each case pushes about `frames` screens worth of pixels. payload_bytes is the pixel
+     * data of one op in the panel format; bus_bytes is everything sent per op (commands and parameters included)
+     * as counted by GC9A01_STATS, empty when the statistics are not compiled in. The pixel format and color
+     * order of display are restored afterwards.
+     * */
+    void Suite(GC9A01& display, unsigned int frames = 2U);
+}
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef GC9A01_COMMAND_LISTS_HPP
+#define GC9A01_COMMAND_LISTS_HPP
+
+#include "GC9A01.hpp"
+
+/* Byte coded command lists, replayed by GC9A01::SendCommandList under a single CS assertion.
+ *
+ * Every entry is: command, argument count, arguments..., [delay]
+ * When DELAY is set in the argument count, one more byte follows the arguments: the time to wait
+ * after the command, in milliseconds.
+ *
+ * The lists live in flash and carry the bytes the former WriteCycleSequence based Init() and
+ * Adafruit_Init() sent (see GC9A01Diagnostics::CompareInitSequences), with one intended change: where
+ * the former TearingEffectOn(false) sent TearingEffectLineOFF (34h) 00h, the lists send
+ * TearingEffectLineON (35h) 00h, so both inits now leave the TE output on (V-Blanking only).
+ * */
+namespace GC9A01CommandLists {
+    static constexpr unsigned char DELAY = 0x80U;
+
+    static constexpr unsigned char Init[] = {
+        0x01, 0U,                                                       // Software reset
+        InterCommandSet::InterRegisterEnable1, 0U,
+        InterCommandSet::InterRegisterEnable2, 0U,
+
+        // Undocumented in datasheet registers
+        0xEB, 1U, 0x14,
+        0x84, 1U, 0x60,
+        0x85, 1U, 0xF7,
+        0x86, 1U, 0xFC,
+        0x87, 1U, 0x28,
+        0x8E, 1U, 0x0F,
+        0x8F, 1U, 0xFC,
+        0x88, 1U, 0x0A,
+        0x89, 1U, 0x21,
+        0x8A, 1U, 0x00,
+        0x8B, 1U, 0x80,
+        0x8C, 1U, 0x01,
+        0x8D, 1U, 0x03,
+
+        // The first parameter is not valid, GS_OFF | SS_OFF
+        ExtendedCommandSet::DisplayFunctionControl, 2U, 0x00, DisplayFunctionControlOptions::GS_OFF | DisplayFunctionControlOptions::SS_OFF,
+        RegulativeCommandSet::MemoryAccessControl, 1U, MemoryAccessControlOptions::RGB | MemoryAccessControlOptions::MX,
+        RegulativeCommandSet::COLMODPixelFormatSet, 1U, COLMOD::DBI12BitPerPixel | COLMOD::DPI16BitPerPixel,
+
+        // Undocumented in datasheet registers
+        0x90, 4U, 0x08, 0x08, 0x08, 0x08,
+        // Positive pulse, 2 lines
+        ExtendedCommandSet::TearingEffectControl, 1U, 0x01,
+        0xBD, 1U, 0x06,
+        0xBC, 1U, 0x00,
+        0xFF, 3U, 0x60, 0x01, 0x04,
+
+        InterCommandSet::PowerControl2, 1U, 0x48,
+        InterCommandSet::PowerControl3, 1U, 0x48,
+        InterCommandSet::PowerControl4, 1U, 0x25,
+
+        // Undocumented in datasheet registers
+        0xBE, 1U, 0x11,
+        0xE1, 2U, 0x10, 0x0E,
+        0xDF, 3U, 0x21, 0x10, 0x02,
+
+        // Gamma
+        InterCommandSet::SetGamma1, 6U, 0x4B, 0x0F, 0x0A, 0x0B, 0x15, 0x30,
+        InterCommandSet::SetGamma2, 6U, 0x43, 0x70, 0x72, 0x36, 0x37, 0x6F,
+        InterCommandSet::SetGamma3, 6U, 0x4B, 0x0F, 0x0A, 0x0B, 0x15, 0x30,
+        InterCommandSet::SetGamma4, 6U, 0x43, 0x70, 0x72, 0x36, 0x37, 0x6F,
+
+        RegulativeCommandSet::SetTearScanline, 2U, 0x00, 0x00,
+
+        // Undocumented in datasheet registers
+        0xED, 2U, 0x1B, 0x0B,
+        0xAC, 1U, 0x47,
+        0xAE, 1U, 0x77,
+        0xCD, 1U, 0x63,
+        // From the manufacturer's boilerplate code, Adafruit_Init leaves it out
+        0x70, 9U, 0x07, 0x09, 0x04, 0x0C, 0x0D, 0x09, 0x07, 0x08, 0x03,
+
+        // Four dot inversion (the low bits have to be set, see SetFrameRate)
+        InterCommandSet::FrameRate, 1U, FrameRateOptions::FourDotInversion | 0x04U,
+
+        // Undocumented in datasheet registers
+        0x60, 8U, 0x38, 0x0B, 0x76, 0x62, 0x39, 0xF0, 0x76, 0x62,
+        0x61, 8U, 0x38, 0xF6, 0x76, 0x62, 0x38, 0xF7, 0x76, 0x62,
+        0x62, 12U, 0x38, 0x0D, 0x71, 0xED, 0x76, 0x62, 0x38, 0x0F, 0x71, 0xEF, 0x76, 0x62,
+        0x63, 12U, 0x38, 0x11, 0x71, 0xF1, 0x76, 0x62, 0x38, 0x13, 0x71, 0xF3, 0x76, 0x62,
+        0x64, 7U, 0x3B, 0x29, 0xF1, 0x01, 0xF1, 0x00, 0x0A,
+        0x66, 10U, 0x3C, 0x00, 0xCD, 0x67, 0x45, 0x45, 0x10, 0x00, 0x00, 0x00,
+        0x67, 10U, 0x00, 0x3C, 0x00, 0x00, 0x00, 0x01, 0x54, 0x10, 0x32, 0x98,
+
+        ExtendedCommandSet::BlankingPorchControl, 3U, 0x08, 0x09, 0x14,
+
+        // Undocumented in datasheet registers
+        0x74, 7U, 0x10, 0x85, 0x80, 0x00, 0x00, 0x4E, 0x00,
+        0x98, 2U, 0x3E, 0x07,
+
+        RegulativeCommandSet::NormalMode, 0U,
+        RegulativeCommandSet::TearingEffectLineOFF, 0U,
+        RegulativeCommandSet::IdleModeOFF, 0U,
+        // TE output on, V-Blanking only (34h 00h before, see above)
+        RegulativeCommandSet::TearingEffectLineON, 1U, 0x00,
+        RegulativeCommandSet::InversionON, 0U,
+        RegulativeCommandSet::SleepOUT, DELAY | 0U, 120U,
+        RegulativeCommandSet::DisplayON, 0U,
+    };
+
+    static constexpr unsigned char Adafruit_Init[] = {
+        InterCommandSet::InterRegisterEnable2, 0U,
+        0xEB, 1U, 0x14,
+        InterCommandSet::InterRegisterEnable1, 0U,
+        InterCommandSet::InterRegisterEnable2, 0U,
+
+        // Undocumented in datasheet registers
+        0xEB, 1U, 0x14,
+        0x84, 1U, 0x40,
+        0x85, 1U, 0xFF,
+        0x86, 1U, 0xFF,
+        0x87, 1U, 0xFF,
+        0x88, 1U, 0x0A,
+        0x89, 1U, 0x21,
+        0x8A, 1U, 0x00,
+        0x8B, 1U, 0x80,
+        0x8C, 1U, 0x01,
+        0x8D, 1U, 0x01,
+        0x8E, 1U, 0xFF,
+        0x8F, 1U, 0xFF,
+
+        RegulativeCommandSet::MemoryAccessControl, 1U, MemoryAccessControlOptions::RGB | MemoryAccessControlOptions::MX,
+        RegulativeCommandSet::COLMODPixelFormatSet, 1U, COLMOD::DBI16BitPerPixel,
+
+        // Undocumented in datasheet registers
+        0x90, 4U, 0x08, 0x08, 0x08, 0x08,
+        0xBD, 1U, 0x06,
+        0xBC, 1U, 0x00,
+        0xFF, 3U, 0x60, 0x01, 0x04,
+
+        InterCommandSet::PowerControl2, 1U, 0x13,
+        InterCommandSet::PowerControl3, 1U, 0x13,
+        InterCommandSet::PowerControl4, 1U, 0x22,
+
+        // Undocumented in datasheet registers
+        0xBE, 1U, 0x11,
+        0xE1, 2U, 0x10, 0x0E,
+        0xDF, 3U, 0x21, 0x0C, 0x02,
+
+        // Gamma
+        InterCommandSet::SetGamma1, 6U, 0x45, 0x09, 0x08, 0x08, 0x26, 0x2A,
+        InterCommandSet::SetGamma2, 6U, 0x43, 0x70, 0x72, 0x36, 0x37, 0x6F,
+        InterCommandSet::SetGamma3, 6U, 0x45, 0x09, 0x08, 0x08, 0x26, 0x2A,
+        InterCommandSet::SetGamma4, 6U, 0x43, 0x70, 0x72, 0x36, 0x37, 0x6F,
+
+        // Undocumented in datasheet registers
+        0xED, 2U, 0x1B, 0x0B,
+        0xAE, 1U, 0x77,
+        0xCD, 1U, 0x63,
+
+        // Four dot inversion (the low bits have to be set, see SetFrameRate)
+        InterCommandSet::FrameRate, 1U, FrameRateOptions::FourDotInversion | 0x04U,
+
+        // Undocumented in datasheet registers
+        0x62, 12U, 0x18, 0x0D, 0x71, 0xED, 0x70, 0x70, 0x18, 0x0F, 0x71, 0xEF, 0x70, 0x70,
+        0x63, 12U, 0x18, 0x11, 0x71, 0xF1, 0x70, 0x70, 0x18, 0x13, 0x71, 0xF3, 0x70, 0x70,
+        0x64, 7U, 0x28, 0x29, 0xF1, 0x01, 0xF1, 0x00, 0x07,
+        0x66, 10U, 0x3C, 0x00, 0xCD, 0x67, 0x45, 0x45, 0x10, 0x00, 0x00, 0x00,
+        0x67, 10U, 0x00, 0x3C, 0x00, 0x00, 0x00, 0x01, 0x54, 0x10, 0x32, 0x98,
+        0x74, 7U, 0x10, 0x85, 0x80, 0x00, 0x00, 0x4E, 0x00,
+        0x98, 2U, 0x3E, 0x07,
+
+        // TE output on, V-Blanking only (34h 00h before, see above)
+        RegulativeCommandSet::TearingEffectLineON, 1U, 0x00,
+        RegulativeCommandSet::InversionON, 0U,
+        RegulativeCommandSet::SleepOUT, DELAY | 0U, 120U,
+        RegulativeCommandSet::DisplayON, 0U,
+    };
+}
+
+#endif
@@ -0,0 +1,225 @@
+#include <string.h>
+#include "GC9A01_Compositor.hpp"
+#include "GC9A01_Font.hpp"
+
+namespace {
+    // Writes color over pixel, mixed with what is there unless alpha is 255
+    inline void Put(unsigned char pixel[], const unsigned char color[], unsigned char alpha) {
+        if (255U == alpha) {
+            pixel[0] = color[0];
+            pixel[1] = color[1];
+            pixel[2] = color[2];
+            return;
+        }
+        for (size_t i = 0U; i < RGB_COUNT; ++i) {
+            pixel[i] = (color[i] * alpha + pixel[i] * (255U - alpha) + 127U) / 255U;
+        }
+    }
+}
+
+GC9A01Compositor::GC9A01Compositor(const GC9A01& display)
+ : display(display), count(0U), background{0U, 0U, 0U} { }
+
+void GC9A01Compositor::SetBackground(unsigned char r, unsigned char g, unsigned char b) {
+    this->background[0] = r;
+    this->background[1] = g;
+    this->background[2] = b;
+}
+
+size_t GC9A01Compositor::Add(LayerType type, unsigned short x, unsigned short y, unsigned short w, unsigned short h) {
+    if (GC9A01_MAX_LAYERS == this->count) {
+        return INVALID_LAYER;
+    }
+    Layer& layer = this->layers[this->count];
+    memset(&layer, 0, sizeof(layer));
+    layer.type = type;
+    layer.visible = true;
+    layer.alpha = 255U;
+    layer.x = x;
+    layer.y = y;
+    layer.w = w;
+    layer.h = h;
+    layer.scale = 1U;
+    ++this->count;
+    return this->count - 1U;
+}
+
+size_t GC9A01Compositor::AddSolid(unsigned short x, unsigned short y, unsigned short w, unsigned short h, unsigned char r, unsigned char g, unsigned char b) {
+    const size_t layer = this->Add(LayerSolid, x, y, w, h);
+    if (INVALID_LAYER != layer) {
+        this->SetColor(layer, r, g, b);
+    }
+    return layer;
+}
+
+size_t GC9A01Compositor::AddImage(unsigned short x, unsigned short y, unsigned short w, unsigned short h, const unsigned char image[]) {
+    const size_t layer = this->Add(LayerImage, x, y, w, h);
+    if (INVALID_LAYER != layer) {
+        this->layers[layer].data = image;
+    }
+    return layer;
+}
+
+size_t GC9A01Compositor::AddSprite(unsigned short x, unsigned short y, unsigned short w, unsigned short h, const unsigned char image[],
+                                   unsigned char keyR, unsigned char keyG, unsigned char keyB) {
+    const size_t layer = this->Add(LayerSprite, x, y, w, h);
+    if (INVALID_LAYER != layer) {
+        this->layers[layer].data = image;
+        this->SetColor(layer, keyR, keyG, keyB);
+    }
+    return layer;
+}
+
+size_t GC9A01Compositor::AddGlyphs(unsigned short x, unsigned short y, const char* text, unsigned char r, unsigned char g, unsigned char b, unsigned char scale) {
+    const size_t layer = this->Add(LayerGlyphs, x, y, 0U, GC9A01Font::HEIGHT * scale);
+    if (INVALID_LAYER != layer) {
+        this->layers[layer].scale = scale;
+        this->SetColor(layer, r, g, b);
+        this->SetText(layer, text);
+    }
+    return layer;
+}
+
+size_t GC9A01Compositor::AddSource(unsigned short x, unsigned short y, unsigned short w, unsigned short h, SpanSource source, void* context) {
+    const size_t layer = this->Add(LayerSource, x, y, w, h);
+    if (INVALID_LAYER != layer) {
+        this->layers[layer].source = source;
+        this->layers[layer].context = context;
+    }
+    return layer;
+}
+
+void GC9A01Compositor::SetPosition(size_t layer, unsigned short x, unsigned short y) {
+    this->layers[layer].x = x;
+    this->layers[layer].y = y;
+}
+
+void GC9A01Compositor::SetVisible(size_t layer, bool visible) {
+    this->layers[layer].visible = visible;
+}
+
+void GC9A01Compositor::SetAlpha(size_t layer, unsigned char alpha) {
+    this->layers[layer].alpha = alpha;
+}
+
+void GC9A01Compositor::SetColor(size_t layer, unsigned char r, unsigned char g, unsigned char b) {
+    this->layers[layer].color[0] = r;
+    this->layers[layer].color[1] = g;
+    this->layers[layer].color[2] = b;
+}
+
+void GC9A01Compositor::SetText(size_t layer, const char* text) {
+    this->layers[layer].data = text;
+    this->layers[layer].w = GC9A01Font::GetTextWidth(strlen(text), this->layers[layer].scale);
+}
+
+void GC9A01Compositor::SetImage(size_t layer, const unsigned char image[]) {
+    this->layers[layer].data = image;
+}
+
+bool GC9A01Compositor::IsOpaque(const Layer& layer) const {
+    return (LayerSource == layer.type) || ((255U == layer.alpha) && ((LayerSolid == layer.type) || (LayerImage == layer.type)));
+}
+
+void GC9A01Compositor::DrawSpan(const Layer& layer, unsigned short x, unsigned short y, unsigned short w, unsigned char rgb[]) const {
+    const unsigned short left = (x > layer.x) ? x : layer.x;
+    const unsigned short right = ((x + w) < (layer.x + layer.w)) ? (x + w) : (layer.x + layer.w);
+    if (left >= right) {
+        return;
+    }
+    unsigned char* const out = &rgb[(left - x) * RGB_COUNT];
+    const unsigned short count = right - left;
+
+    switch (layer.type)
+    {
+    case LayerSolid:
+        for (unsigned short i = 0U; i < count; ++i) {
+            Put(&out[i * RGB_COUNT], layer.color, layer.alpha);
+        }
+        break;
+    case LayerImage:
+    case LayerSprite:
+    {
+        const unsigned char* const source = &static_cast<const unsigned char*>(layer.data)[((y - layer.y) * layer.w + (left - layer.x)) * RGB_COUNT];
+        if ((LayerImage == layer.type) && (255U == layer.alpha)) {
+            memcpy(out, source, count * RGB_COUNT);
+            break;
+        }
+        for (unsigned short i = 0U; i < count; ++i) {
+            const unsigned char* const pixel = &source[i * RGB_COUNT];
+            if ((LayerSprite == layer.type) && (pixel[0] == layer.color[0]) && (pixel[1] == layer.color[1]) && (pixel[2] == layer.color[2])) {
+                continue;
+            }
+            Put(&out[i * RGB_COUNT], pixel, layer.alpha);
+        }
+        break;
+    }
+    case LayerGlyphs:
+    {
+        const char* const text = static_cast<const char*>(layer.data);
+        const unsigned char bit = 1U << ((y - layer.y) / layer.scale);
+        const unsigned short cell = GC9A01Font::ADVANCE * layer.scale;
+        for (unsigned short i = 0U; i < count; ++i) {
+            const unsigned short offset = left + i - layer.x;
+            const unsigned short column = (offset % cell) / layer.scale;
+            if ((column < GC9A01Font::WIDTH) && (0U != (GC9A01Font::GetGlyph(text[offset / cell])[column] & bit))) {
+                Put(&out[i * RGB_COUNT], layer.color, layer.alpha);
+            }
+        }
+        break;
+    }
+    default:
+        layer.source(layer.context, left, y, count, out);
+        break;
+    }
+}
+
+void GC9A01Compositor::Compose(unsigned short x, unsigned short y, unsigned short w, unsigned char rgb[]) const {
+    // Nothing under the topmost opaque layer covering the whole span can show
+    size_t first = 0U;
+    bool covered = false;
+    for (size_t i = this->count; (0U < i) && !covered; --i) {
+        const Layer& layer = this->layers[i - 1U];
+        if (layer.visible && this->IsOpaque(layer) && (y >= layer.y) && (y < (layer.y + layer.h)) && (x >= layer.x) &&
+            ((x + w) <= (layer.x + layer.w))) {
+            first = i - 1U;
+            covered = true;
+        }
+    }
+    if (!covered) {
+        for (unsigned short i = 0U; i < w; ++i) {
+            memcpy(&rgb[i * RGB_COUNT], this->background, RGB_COUNT);
+        }
+    }
+
+    for (size_t i = first; i < this->count; ++i) {
+        const Layer& layer = this->layers[i];
+        if (layer.visible && (0U != layer.alpha) && (y >= layer.y) && (y < (layer.y + layer.h))) {
+            this->DrawSpan(layer, x, y, w, rgb);
+        }
+    }
+}
+
+void GC9A01Compositor::ComposeChunk(void* context, size_t pixelCount, unsigned char rgb[]) {
+    Cursor* const cursor = static_cast<Cursor*>(context);
+    while (0U < pixelCount) {
+        const unsigned short rowLeft = cursor->x0 + cursor->w - cursor->x;
+        const unsigned short count = (pixelCount < rowLeft) ? pixelCount : rowLeft;
+        cursor->compositor->Compose(cursor->x, cursor->y, count, rgb);
+        rgb += count * RGB_COUNT;
+        pixelCount -= count;
+        cursor->x += count;
+        if ((cursor->x0 + cursor->w) == cursor->x) {
+            cursor->x = cursor->x0;
+            ++cursor->y;
+        }
+    }
+}
+
+void GC9A01Compositor::Render(unsigned short x0, unsigned short y0, unsigned short w, unsigned short h) const {
+    if ((0U == w) || (0U == h)) {
+        return;
+    }
+    Cursor cursor = {this, x0, w, x0, y0};
+    this->display.WritePixels(x0, y0, w, h, &GC9A01Compositor::ComposeChunk, &cursor);
+}
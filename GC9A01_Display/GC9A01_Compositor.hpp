@@ -0,0 +1,105 @@
+#ifndef GC9A01_COMPOSITOR_HPP
+#define GC9A01_COMPOSITOR_HPP
+
+#include "GC9A01.hpp"
+
+// Layers a compositor holds
+#ifndef GC9A01_MAX_LAYERS
+#define GC9A01_MAX_LAYERS 8U
+#endif
+
+/* Composites a stack of layers (solid rectangles, RGB888 images, color keyed sprites, text and application spans)
+ * row by row while the rectangle is sent, without a framebuffer or band.
+ *
+ * Render() opens one memory write (WritePixels) and every chunk the driver asks for is composited straight into its
+ * conversion scratch, bottom layer first, then converted to the panel format in place and sent while the next chunk
+ * is composited. The RAM used is the driver scratch (two scanlines by default, see GC9A01_CHUNK_ROWS) whatever the
+ * number of layers; images and text stay where the application keeps them, e.g. in flash.
+ *
+ * For each span only the layers from the topmost opaque one covering it are drawn, so a full screen background
+ * image under a few widgets costs one copy per pixel. Layers are drawn in the order they were added, with an
+ * optional alpha each.
+ * */
+class GC9A01Compositor
+{
+public:
+    typedef enum {
+        LayerSolid,
+        LayerImage,
+        LayerSprite,
+        LayerGlyphs,
+        LayerSource
+    } LayerType;
+    // Writes w pixels of screen row y from column x as RGB888 into rgb, for layers the application computes
+    typedef void (*SpanSource)(void* context, unsigned short x, unsigned short y, unsigned short w, unsigned char rgb[]);
+    // Returned by the Add calls when the compositor is full
+    static constexpr size_t INVALID_LAYER = static_cast<size_t>(-1);
+private:
+    typedef struct {
+        LayerType type;
+        bool visible;
+        unsigned char alpha;
+        unsigned short x;
+        unsigned short y;
+        unsigned short w;
+        unsigned short h;
+        // Fill color, text color or sprite key
+        unsigned char color[RGB_COUNT];
+        // Image, sprite or text
+        const void* data;
+        unsigned char scale;
+        SpanSource source;
+        void* context;
+    } Layer;
+
+    // Where Render is in the rectangle, the driver asks for the pixels in chunks that need not end on a row
+    typedef struct {
+        const GC9A01Compositor* compositor;
+        unsigned short x0;
+        unsigned short w;
+        unsigned short x;
+        unsigned short y;
+    } Cursor;
+
+    const GC9A01& display;
+    Layer layers[GC9A01_MAX_LAYERS];
+    size_t count;
+    unsigned char background[RGB_COUNT];
+
+    size_t Add(LayerType type, unsigned short x, unsigned short y, unsigned short w, unsigned short h);
+    // True when the layer is drawn without showing what is under it
+    bool IsOpaque(const Layer& layer) const;
+    void DrawSpan(const Layer& layer, unsigned short x, unsigned short y, unsigned short w, unsigned char rgb[]) const;
+    // Composites w pixels of row y from column x into rgb
+    void Compose(unsigned short x, unsigned short y, unsigned short w, unsigned char rgb[]) const;
+    static void ComposeChunk(void* context, size_t pixelCount, unsigned char rgb[]);
+public:
+    explicit GC9A01Compositor(const GC9A01& display);
+    // Color of the pixels no layer covers
+    void SetBackground(unsigned char r, unsigned char g, unsigned char b);
+    size_t AddSolid(unsigned short x, unsigned short y, unsigned short w, unsigned short h, unsigned char r, unsigned char g, unsigned char b);
+    // RGB888 image of w x h pixels, owned by the caller
+    size_t AddImage(unsigned short x, unsigned short y, unsigned short w, unsigned short h, const unsigned char image[]);
+    // RGB888 image whose pixels of the key color are transparent
+    size_t AddSprite(unsigned short x, unsigned short y, unsigned short w, unsigned short h, const unsigned char image[],
+                     unsigned char keyR, unsigned char keyG, unsigned char keyB);
+    // Text in GC9A01Font over what is under it, scale 1 gives 5x7 pixel characters
+    size_t AddGlyphs(unsigned short x, unsigned short y, const char* text, unsigned char r, unsigned char g, unsigned char b, unsigned char scale = 1U);
+    size_t AddSource(unsigned short x, unsigned short y, unsigned short w, unsigned short h, SpanSource source, void* context);
+    inline size_t GetCount() const { return this->count; }
+    // Removes every layer
+    inline void Clear() { this->count = 0U; }
+
+    void SetPosition(size_t layer, unsigned short x, unsigned short y);
+    void SetVisible(size_t layer, bool visible);
+    // 255 draws the layer as it is, 0 hides it. Source layers are always drawn opaque
+    void SetAlpha(size_t layer, unsigned char alpha);
+    void SetColor(size_t layer, unsigned char r, unsigned char g, unsigned char b);
+    void SetText(size_t layer, const char* text);
+    void SetImage(size_t layer, const unsigned char image[]);
+
+    // Composites and sends the area x0, y0, w, h (the full screen by default) in one memory write
+    void Render(unsigned short x0 = 0U, unsigned short y0 = 0U, unsigned short w = MAX_WIDTH, unsigned short h = MAX_HEIGHT) const;
+};
+
+#endif
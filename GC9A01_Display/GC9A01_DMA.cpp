@@ -0,0 +1,211 @@
+#include "GC9A01_DMA.hpp"
+
+#ifdef GC9A01_HOST
+
+#include <string.h>
+
+GC9A01DMA::GC9A01DMA(spi_inst_t* spi_instance)
+ : spi_instance(spi_instance), channel(0U), callback(nullptr), context(nullptr), busy(false),
+   hostData(nullptr), hostDataSize(0U), hostDoneAtNs(0U), hostPatternSize(0U) { }
+
+GC9A01DMA::~GC9A01DMA() {
+    this->WaitIdle();
+}
+
+void GC9A01DMA::Start(const unsigned char data[], size_t dataSize, CompletionCallback callback, void* context) {
+    this->callback = callback;
+    this->context = context;
+    this->hostData = data;
+    this->hostDataSize = dataSize;
+    this->hostPatternSize = 0U;
+    this->hostDoneAtNs = GC9A01HAL::ScheduleTransfer(this->spi_instance, dataSize);
+    this->busy = true;
+}
+
+void GC9A01DMA::StartRepeat(const unsigned char pattern[], size_t patternSize, size_t totalSize, CompletionCallback callback, void* context) {
+    this->callback = callback;
+    this->context = context;
+    memcpy(this->hostPattern, pattern, patternSize);
+    this->hostPatternSize = patternSize;
+    this->hostDataSize = totalSize;
+    this->hostDoneAtNs = GC9A01HAL::ScheduleTransfer(this->spi_instance, totalSize);
+    this->busy = true;
+}
+
+void GC9A01DMA::HostService() {
+    if (this->busy && (GC9A01HAL::TimeNs() >= this->hostDoneAtNs)) {
+        if (0U == this->hostPatternSize) {
+            // The payload is read when the transfer completes, so a buffer released too early shows up as corruption
+            GC9A01HAL::DeliverTransfer(this->spi_instance, this->hostData, this->hostDataSize);
+        } else {
+            // Tight repeat loop, a multiple of every pattern size at a time
+            unsigned char block[96U];
+            for (size_t i = 0U; i < sizeof(block); ++i) {
+                block[i] = this->hostPattern[i % this->hostPatternSize];
+            }
+            const size_t blockSize = sizeof(block) - (sizeof(block) % this->hostPatternSize);
+            for (size_t sent = 0U; sent < this->hostDataSize; sent += blockSize) {
+                const size_t left = this->hostDataSize - sent;
+                GC9A01HAL::DeliverTransfer(this->spi_instance, block, (left < blockSize) ? left : blockSize);
+            }
+        }
+        this->Complete();
+    }
+}
+
+bool GC9A01DMA::IsBusy() {
+    this->HostService();
+    return this->busy;
+}
+
+void GC9A01DMA::WaitIdle() {
+    while (this->busy) {
+        GC9A01HAL::WaitUntilNs(this->hostDoneAtNs);
+        this->HostService();
+    }
+}
+
+#else
+
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+static GC9A01DMA* channelOwners[NUM_DMA_CHANNELS] = { nullptr };
+static bool irqHandlerInstalled = false;
+
+GC9A01DMA::GC9A01DMA(spi_inst_t* spi_instance)
+ : spi_instance(spi_instance), channel(dma_claim_unused_channel(true)), callback(nullptr), context(nullptr), busy(false),
+   repeatByte(0U), frameBits(8U) {
+    channelOwners[this->channel] = this;
+    dma_channel_set_irq0_enabled(this->channel, true);
+    if (!irqHandlerInstalled) {
+        // Shared, so the application can still use DMA_IRQ_0 for its own channels
+        irq_add_shared_handler(DMA_IRQ_0, &GC9A01DMA::IrqHandler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+        irqHandlerInstalled = true;
+    }
+}
+
+GC9A01DMA::~GC9A01DMA() {
+    this->WaitIdle();
+    dma_channel_set_irq0_enabled(this->channel, false);
+    channelOwners[this->channel] = nullptr;
+    dma_channel_unclaim(this->channel);
+}
+
+void GC9A01DMA::Start(const unsigned char data[], size_t dataSize, CompletionCallback callback, void* context) {
+    this->callback = callback;
+    this->context = context;
+    this->busy = true;
+    if (0U == dataSize) {
+        // Nothing to pace, a zero length transfer would never raise the IRQ
+        this->Complete();
+        return;
+    }
+
+    dma_channel_config config = dma_channel_get_default_config(this->channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+    channel_config_set_dreq(&config, spi_get_dreq(this->spi_instance, true));
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    dma_channel_configure(this->channel, &config, &spi_get_hw(this->spi_instance)->dr, data, dataSize, true);
+}
+
+void GC9A01DMA::StartRepeat(const unsigned char pattern[], size_t patternSize, size_t totalSize, CompletionCallback callback, void* context) {
+    bool uniform = true;
+    for (size_t i = 1U; i < patternSize; ++i) {
+        uniform = uniform && (pattern[i] == pattern[0]);
+    }
+
+    this->callback = callback;
+    this->context = context;
+    this->busy = true;
+    if (0U == totalSize) {
+        this->Complete();
+        return;
+    }
+
+    dma_channel_config config = dma_channel_get_default_config(this->channel);
+    channel_config_set_dreq(&config, spi_get_dreq(this->spi_instance, true));
+    channel_config_set_write_increment(&config, false);
+    const void* source = nullptr;
+    size_t transferCount = 0U;
+
+    if (uniform) {
+        this->repeatByte = pattern[0];
+        channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+        channel_config_set_read_increment(&config, false);
+        source = &this->repeatByte;
+        transferCount = totalSize;
+    } else if (2U == patternSize) {
+        this->frameBits = 16U;
+        this->repeatFrames[0] = (pattern[0] << 8U) | pattern[1];
+        channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+        channel_config_set_read_increment(&config, false);
+        source = this->repeatFrames;
+        transferCount = totalSize / 2U;
+    } else {
+        // 24 bits as two 12 bit frames, an odd 12 bit pixel count ends on a half pattern (the padding nibble is not sent)
+        this->frameBits = 12U;
+        this->repeatFrames[0] = (pattern[0] << 4U) | (pattern[1] >> 4U);
+        this->repeatFrames[1] = ((pattern[1] & 0x0FU) << 8U) | pattern[2];
+        channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+        channel_config_set_read_increment(&config, true);
+        channel_config_set_ring(&config, false, 2U);
+        source = this->repeatFrames;
+        transferCount = (totalSize * 8U) / 12U;
+    }
+
+    if (8U != this->frameBits) {
+        GC9A01HAL::SpiSetFrameBits(this->spi_instance, this->frameBits);
+    }
+    dma_channel_configure(this->channel, &config, &spi_get_hw(this->spi_instance)->dr, source, transferCount, true);
+}
+
+bool GC9A01DMA::IsBusy() {
+    return this->busy;
+}
+
+void GC9A01DMA::WaitIdle() {
+    while (this->busy) {
+        tight_loop_contents();
+    }
+}
+
+void GC9A01DMA::IrqHandler() {
+    for (unsigned int channel = 0U; channel < NUM_DMA_CHANNELS; ++channel) {
+        GC9A01DMA* const owner = channelOwners[channel];
+        if ((nullptr != owner) && dma_channel_get_irq0_status(channel)) {
+            dma_channel_acknowledge_irq0(channel);
+            owner->Complete();
+        }
+    }
+}
+
+#endif
+
+void GC9A01DMA::Complete() {
+#ifndef GC9A01_HOST
+    // The channel is done once the last byte is in the TX FIFO, wait until it left the shift register
+    while (spi_is_busy(this->spi_instance)) {
+        tight_loop_contents();
+    }
+    // Nothing reads the RX FIFO during the transfer, drop what was received and clear the overrun flag
+    while (spi_is_readable(this->spi_instance)) {
+        (void)spi_get_hw(this->spi_instance)->dr;
+    }
+    spi_get_hw(this->spi_instance)->icr = SPI_SSPICR_RORIC_BITS;
+    if (8U != this->frameBits) {
+        GC9A01HAL::SpiSetFrameBits(this->spi_instance, 8U);
+        this->frameBits = 8U;
+    }
+#endif
+    // The callback is allowed to start the next transfer
+    const CompletionCallback callback = this->callback;
+    void* const context = this->context;
+    this->callback = nullptr;
+    this->busy = false;
+    if (nullptr != callback) {
+        callback(context);
+    }
+}
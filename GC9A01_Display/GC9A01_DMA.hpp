@@ -0,0 +1,65 @@
+#ifndef GC9A01_DMA_HPP
+#define GC9A01_DMA_HPP
+
+#include <stddef.h>
+#include "GC9A01_HAL.hpp"
+
+/* One DMA channel that streams a byte buffer into the TX FIFO of an SPI instance.
+ *
+ * On the RP2040 the channel is paced by the SPI TX DREQ, so the CPU is free while the payload is shifted out.
+ * The completion callback is called from the DMA_IRQ_0 handler once the last byte has left the shift register,
+ * so the caller can safely release CS from it.
+ *
+ * On the host build (GC9A01_HOST) the transfer is carried out by a simulated engine: the bus is reserved through
+ * the HAL, the payload is delivered to the emulator once the modeled wire time has elapsed, and the completion
+ * callback is called from IsBusy() / WaitIdle() (the host has no interrupts, so the "IRQ" fires when the driver polls).
+ * */
+class GC9A01DMA
+{
+public:
+    typedef void (*CompletionCallback)(void* context);
+    static constexpr size_t MAX_REPEAT_PATTERN = 3U;
+private:
+    spi_inst_t* spi_instance;
+    unsigned int channel;
+    CompletionCallback callback;
+    void* context;
+    volatile bool busy;
+#ifdef GC9A01_HOST
+    const unsigned char* hostData;
+    size_t hostDataSize;
+    unsigned long long hostDoneAtNs;
+    // Repeated transfers: the pattern and how many bytes of it to deliver
+    unsigned char hostPattern[MAX_REPEAT_PATTERN];
+    size_t hostPatternSize;
+    void HostService();
+#else
+    // Source of repeated transfers, the read address never leaves it
+    alignas(4) unsigned short repeatFrames[2U];
+    unsigned char repeatByte;
+    unsigned char frameBits;
+    static void IrqHandler();
+#endif
+    void Complete();
+public:
+    GC9A01DMA(spi_inst_t* spi_instance);
+    ~GC9A01DMA();
+    /* Start streaming dataSize bytes from data. The buffer must stay valid until the completion callback
+     * has been called. Only one transfer can be in flight, the caller is expected to check IsBusy() first.
+     * */
+    void Start(const unsigned char data[], size_t dataSize, CompletionCallback callback, void* context);
+    /* Stream totalSize bytes made of pattern repeated back to back, e.g. a solid fill. The pattern is copied,
+     * so the payload costs no RAM whatever its size.
+     *
+     * On the RP2040 the DMA read address does not advance: a pattern of identical bytes is sent as 8 bit frames,
+     * a 2 byte pattern (one 16 bit pixel) as one 16 bit frame and a 3 byte pattern (a 12 bit pixel pair or an
+     * 18 bit pixel) as two 12 bit frames read from a 4 byte ring. The SPI frame size goes back to 8 bits on completion.
+     *
+     * @param patternSize 1 to MAX_REPEAT_PATTERN bytes
+     * */
+    void StartRepeat(const unsigned char pattern[], size_t patternSize, size_t totalSize, CompletionCallback callback, void* context);
+    bool IsBusy();
+    void WaitIdle();
+};
+
+#endif
@@ -0,0 +1,597 @@
+#include <stdio.h>
+#include <string.h>
+#include "GC9A01_Diagnostics.hpp"
+#include "GC9A01_PixelKernels.hpp"
+
+#ifdef GC9A01_HOST
+
+namespace {
+    // Init() as it was before the command lists, one WriteCycleSequence per command
+    void LegacyInit(const GC9A01& display) {
+        // display.HardwareReset();
+        display.WriteCycleSequence(0x01, nullptr, 0); // Reset?
+
+        display.WriteCycleSequence(InterCommandSet::InterRegisterEnable1, nullptr, 0); // Inter Register Enable1
+        display.WriteCycleSequence(InterCommandSet::InterRegisterEnable2, nullptr, 0); // Inter Register Enable2
+
+        // Undocumented in datasheet registers
+        display.WriteCycleSequence(0xEB, 0x14);
+        display.WriteCycleSequence(0x84, 0x60);
+        display.WriteCycleSequence(0x85, 0xF7);
+        display.WriteCycleSequence(0x86, 0xFC);
+        display.WriteCycleSequence(0x87, 0x28);
+        display.WriteCycleSequence(0x8E, 0x0F);
+        display.WriteCycleSequence(0x8F, 0xFC);
+        display.WriteCycleSequence(0x88, 0x0A);
+        display.WriteCycleSequence(0x89, 0x21);
+        display.WriteCycleSequence(0x8A, 0x00);
+        display.WriteCycleSequence(0x8B, 0x80);
+        display.WriteCycleSequence(0x8C, 0x01);
+        display.WriteCycleSequence(0x8D, 0x03);
+
+        display.SetDisplayFunctionControl(DisplayFunctionControlOptions::GS_OFF | DisplayFunctionControlOptions::SS_OFF);
+
+        // display.WriteCycleSequence(RegulativeCommandSet::MemoryAccessControl, MemoryAccessControlOptions::BGR | MemoryAccessControlOptions::MX);
+        display.WriteCycleSequence(RegulativeCommandSet::MemoryAccessControl, MemoryAccessControlOptions::RGB | MemoryAccessControlOptions::MX);
+        display.WriteCycleSequence(RegulativeCommandSet::COLMODPixelFormatSet, COLMOD::DBI12BitPerPixel | COLMOD::DPI16BitPerPixel);
+            // display.WriteCycleSequence(RegulativeCommandSet::COLMODPixelFormatSet, COLMOD::DBI16BitPerPixel | COLMOD::DPI16BitPerPixel);
+
+        // Undocumented in datasheet registers
+        unsigned char seqReg90[] = {0x08, 0x08, 0x08, 0x08};
+        display.WriteCycleSequence(0x90, seqReg90, 4U);
+
+        display.SetTearingEffectControl(false, 0x01);
+
+        display.WriteCycleSequence(0xBD, 0x06);
+        display.WriteCycleSequence(0xBC, 0x00);
+
+        unsigned char seqRegFF[] = {0x60, 0x01, 0x04};
+        display.WriteCycleSequence(0xFF, seqRegFF, 3U);
+
+        display.WriteCycleSequence(InterCommandSet::PowerControl2, 0x48);
+        display.WriteCycleSequence(InterCommandSet::PowerControl3, 0x48);
+        display.WriteCycleSequence(InterCommandSet::PowerControl4, 0x25);
+
+        // Undocumented in datasheet register
+        display.WriteCycleSequence(0xBE, 0x11);
+        unsigned char seqRegE1[] = {0x10, 0x0E};
+        display.WriteCycleSequence(0xE1, seqRegE1, 2U);
+
+        unsigned char seqRegDF[] = {0x21, 0x10, 0x02};
+        display.WriteCycleSequence(0xDF, seqRegDF, 3U);
+
+        // gamma control sequence
+        unsigned char seqGamma1_3[] = {0x4b, 0x0F, 0x0A, 0x0B, 0x15, 0x30};
+        display.WriteCycleSequence(InterCommandSet::SetGamma1, seqGamma1_3, 6U);
+        unsigned char seqGamma2_4[] = {0x43, 0x70, 0x72, 0x36, 0x37, 0x6F};
+        display.WriteCycleSequence(InterCommandSet::SetGamma2, seqGamma2_4, 6U);
+        display.WriteCycleSequence(InterCommandSet::SetGamma3, seqGamma1_3, 6U);
+        display.WriteCycleSequence(InterCommandSet::SetGamma4, seqGamma2_4, 6U);
+
+        unsigned char seqTearScanline[] = {0x00, 0x00};
+        display.WriteCycleSequence(RegulativeCommandSet::SetTearScanline, seqTearScanline, 2U);
+
+        // Undocumented in datasheet register
+        unsigned char seqRegED[] = {0x1B, 0x0B};
+        display.WriteCycleSequence(0xED, seqRegED, 2U);
+
+        display.WriteCycleSequence(0xAC, 0x47);
+        display.WriteCycleSequence(0xAE, 0x77);
+        display.WriteCycleSequence(0xCD, 0x63);
+
+        // Unsure what this line (from manufacturer's boilerplate code) is
+        // meant to do, but users reported issues, seems to work OK without:
+        unsigned char seqReg70[] = {0x07, 0x09, 0x04, 0x0C, 0x0D, 0x09, 0x07, 0x08, 0x03};
+        display.WriteCycleSequence(0x70, seqReg70, 9U);
+
+        // Frame Rate
+        display.SetFrameRate(FrameRateOptions::FourDotInversion);
+
+        // Undocumented in datasheet registers
+        unsigned char seqReg60[] = {0x38, 0x0B, 0x76, 0x62, 0x39, 0xF0, 0x76, 0x62};
+        display.WriteCycleSequence(0x60, seqReg60, 8U);
+
+        unsigned char seqReg61[] = {0x38, 0xF6, 0x76, 0x62, 0x38, 0xF7, 0x76, 0x62};
+        display.WriteCycleSequence(0x61, seqReg61, 8U);
+
+        unsigned char seqReg62[] = {0x38, 0x0D, 0x71, 0xED, 0x76, 0x62, 0x38, 0x0F, 0x71, 0xEF, 0x76, 0x62};
+        display.WriteCycleSequence(0x62, seqReg62, 12U);
+
+        unsigned char seqReg63[] = {0x38, 0x11, 0x71, 0xF1, 0x76, 0x62, 0x38, 0x13, 0x71, 0xF3, 0x76, 0x62};
+        display.WriteCycleSequence(0x63, seqReg63, 12U);
+
+        unsigned char seqReg64[] = {0x3B, 0x29, 0xF1, 0x01, 0xF1, 0x00, 0x0A};
+        display.WriteCycleSequence(0x64, seqReg64, 7U);
+
+        unsigned char seqReg66[] = {0x3C, 0x00, 0xCD, 0x67, 0x45, 0x45, 0x10, 0x00, 0x00, 0x00};
+        display.WriteCycleSequence(0x66, seqReg66, 10U);
+
+        unsigned char seqReg67[] = {0x00, 0x3C, 0x00, 0x00, 0x00, 0x01, 0x54, 0x10, 0x32, 0x98};
+        display.WriteCycleSequence(0x67, seqReg67, 10U);
+
+        unsigned char seqPorchCtrl[] = {0x08, 0x09, 0x14};
+        display.WriteCycleSequence(ExtendedCommandSet::BlankingPorchControl, seqPorchCtrl, 3U);
+
+        // Undocumented in datasheet registers
+        unsigned char seqReg74[] = {0x10, 0x85, 0x80, 0x00, 0x00, 0x4E, 0x00};
+        display.WriteCycleSequence(0x74, seqReg74, 7U);
+
+        unsigned char seqReg98[] = {0x3E, 0x07};
+        display.WriteCycleSequence(0x98, seqReg98, 2U);
+
+        display.EnterNormalMode();
+        display.WriteCycleSequence(RegulativeCommandSet::TearingEffectLineOFF, nullptr, 0);
+        display.IdleModeOff();
+        // Frozen bytes, not TearingEffectOn(): the original sent 34h 00h here (TearingEffectOn used the wrong
+        // command), this reference carries the intended 35h 00h, TE output on with V-Blanking only
+        display.WriteCycleSequence(RegulativeCommandSet::TearingEffectLineON, 0x00);
+        display.InversionOn();
+        display.WakeUp();
+        GC9A01HAL::SleepMs(120);
+        display.DisplayOn();
+    }
+
+    // Adafruit_Init() as it was before the command lists
+    void LegacyAdafruitInit(const GC9A01& display) {
+        display.WriteCycleSequence(InterCommandSet::InterRegisterEnable2, nullptr, 0); // Inter Register Enable2
+
+        display.WriteCycleSequence(0xEB, 0x14);
+
+        display.WriteCycleSequence(InterCommandSet::InterRegisterEnable1, nullptr, 0); // Inter Register Enable1
+        display.WriteCycleSequence(InterCommandSet::InterRegisterEnable2, nullptr, 0); // Inter Register Enable2
+
+        // Undocumented in datasheet registers
+        display.WriteCycleSequence(0xEB, 0x14);
+        display.WriteCycleSequence(0x84, 0x40);
+        display.WriteCycleSequence(0x85, 0xFF);
+        display.WriteCycleSequence(0x86, 0xFF);
+        display.WriteCycleSequence(0x87, 0xFF);
+        display.WriteCycleSequence(0x88, 0x0A);
+        display.WriteCycleSequence(0x89, 0x21);
+        display.WriteCycleSequence(0x8A, 0x00);
+        display.WriteCycleSequence(0x8B, 0x80);
+        display.WriteCycleSequence(0x8C, 0x01);
+        display.WriteCycleSequence(0x8D, 0x01);
+        display.WriteCycleSequence(0x8E, 0xFF);
+        display.WriteCycleSequence(0x8F, 0xFF);
+
+        display.WriteCycleSequence(RegulativeCommandSet::MemoryAccessControl, MemoryAccessControlOptions::RGB | MemoryAccessControlOptions::MX);
+
+        display.WriteCycleSequence(RegulativeCommandSet::COLMODPixelFormatSet, COLMOD::DBI16BitPerPixel);
+
+        // Undocumented in datasheet registers
+        const unsigned char seqReg90[] = {0x08, 0x08, 0x08, 0x08};
+        display.WriteCycleSequence(0x90, seqReg90, 4U);
+
+        display.WriteCycleSequence(0xBD, 0x06);
+        display.WriteCycleSequence(0xBC, 0x00);
+
+        const unsigned char seqRegFF[] = {0x60, 0x01, 0x04};
+        display.WriteCycleSequence(0xFF, seqRegFF, 3U);
+
+        display.WriteCycleSequence(InterCommandSet::PowerControl2, 0x13);
+        display.WriteCycleSequence(InterCommandSet::PowerControl3, 0x13);
+        display.WriteCycleSequence(InterCommandSet::PowerControl4, 0x22);
+
+        // Undocumented in datasheet register
+        display.WriteCycleSequence(0xBE, 0x11);
+        const unsigned char seqRegE1[] = {0x10, 0x0E};
+        display.WriteCycleSequence(0xE1, seqRegE1, 2U);
+
+        unsigned char seqRegDF[] = {0x21, 0x0C, 0x02};
+        display.WriteCycleSequence(0xDF, seqRegDF, 3U);
+
+        // gamma control sequence
+        unsigned char seqGamma1_3[] = {0x45, 0x09, 0x08, 0x08, 0x26, 0x2A};
+        display.WriteCycleSequence(InterCommandSet::SetGamma1, seqGamma1_3, 6U);
+        unsigned char seqGamma2_4[] = {0x43, 0x70, 0x72, 0x36, 0x37, 0x6F};
+        display.WriteCycleSequence(InterCommandSet::SetGamma2, seqGamma2_4, 6U);
+        display.WriteCycleSequence(InterCommandSet::SetGamma3, seqGamma1_3, 6U);
+        display.WriteCycleSequence(InterCommandSet::SetGamma4, seqGamma2_4, 6U);
+
+        // Undocumented in datasheet register
+        unsigned char seqRegED[] = {0x1B, 0x0B};
+        display.WriteCycleSequence(0xED, seqRegED, 2U);
+
+        display.WriteCycleSequence(0xAE, 0x77);
+        display.WriteCycleSequence(0xCD, 0x63);
+
+        // Unsure what this line (from manufacturer's boilerplate code) is
+        // meant to do, but users reported issues, seems to work OK without:
+        // unsigned char seqReg70[] = {0x07, 0x09, 0x04, 0x0C, 0x0D, 0x09, 0x07, 0x08, 0x03};
+        // display.WriteCycleSequence(0x70, seqReg70, 9U);
+
+        // Frame Rate
+        display.SetFrameRate(FrameRateOptions::FourDotInversion);
+
+        // Undocumented in datasheet registers
+        unsigned char seqReg62[] = {0x18, 0x0D, 0x71, 0xED, 0x70, 0x70, 0x18, 0x0F, 0x71, 0xEF, 0x70, 0x70};
+        display.WriteCycleSequence(0x62, seqReg62, 12U);
+
+        unsigned char seqReg63[] = {0x18, 0x11, 0x71, 0xF1, 0x70, 0x70, 0x18, 0x13, 0x71, 0xF3, 0x70, 0x70};
+        display.WriteCycleSequence(0x63, seqReg63, 12U);
+
+        unsigned char seqReg64[] = {0x28, 0x29, 0xF1, 0x01, 0xF1, 0x00, 0x07};
+        display.WriteCycleSequence(0x64, seqReg64, 7U);
+
+        unsigned char seqReg66[] = {0x3C, 0x00, 0xCD, 0x67, 0x45, 0x45, 0x10, 0x00, 0x00, 0x00};
+        display.WriteCycleSequence(0x66, seqReg66, 10U);
+
+        unsigned char seqReg67[] = {0x00, 0x3C, 0x00, 0x00, 0x00, 0x01, 0x54, 0x10, 0x32, 0x98};
+        display.WriteCycleSequence(0x67, seqReg67, 10U);
+
+        // Undocumented in datasheet registers
+        unsigned char seqReg74[] = {0x10, 0x85, 0x80, 0x00, 0x00, 0x4E, 0x00};
+        display.WriteCycleSequence(0x74, seqReg74, 7U);
+
+        unsigned char seqReg98[] = {0x3E, 0x07};
+        display.WriteCycleSequence(0x98, seqReg98, 2U);
+
+        // Frozen bytes, as in LegacyInit: the original sent 34h 00h here
+        display.WriteCycleSequence(RegulativeCommandSet::TearingEffectLineON, 0x00);
+        display.InversionOn();
+        display.WakeUp();
+        GC9A01HAL::SleepMs(120);
+        display.DisplayOn();
+    }
+
+    typedef struct {
+        std::vector<GC9A01LoggedCommand> log;
+        unsigned long long csAssertions;
+        unsigned long long bytes;
+        unsigned long long timeNs;
+    } Capture;
+
+    Capture Record(GC9A01Emulator& emulator, void (*sequence)(const GC9A01&), const GC9A01& display) {
+        Capture capture;
+        emulator.ClearLog();
+        emulator.SetLogEnabled(true);
+        emulator.ResetStats();
+        const unsigned long long start = emulator.NowNs();
+        sequence(display);
+        capture.timeNs = emulator.NowNs() - start;
+        capture.csAssertions = emulator.GetStats().csAssertions;
+        capture.bytes = emulator.GetStats().bytes;
+        capture.log = emulator.GetLog();
+        emulator.SetLogEnabled(false);
+        emulator.ClearLog();
+        return capture;
+    }
+
+    bool Compare(const char* name, const Capture& legacy, const Capture& replay) {
+        bool same = legacy.log.size() == replay.log.size();
+        for (size_t i = 0U; same && (i < legacy.log.size()); ++i) {
+            if ((legacy.log[i].command != replay.log[i].command) || (legacy.log[i].data != replay.log[i].data)) {
+                printf("%s: command %zu differs, 0x%02X (%zu bytes) instead of 0x%02X (%zu bytes)\n", name, i,
+                       replay.log[i].command, replay.log[i].data.size(), legacy.log[i].command, legacy.log[i].data.size());
+                same = false;
+            }
+        }
+        if (legacy.log.size() != replay.log.size()) {
+            printf("%s: %zu commands instead of %zu\n", name, replay.log.size(), legacy.log.size());
+        }
+        printf("%-14s %s  commands %4zu  bytes %4llu  CS %3llu -> %3llu  time %8.3f -> %8.3f ms\n", name, same ? "same" : "DIFF",
+               replay.log.size(), replay.bytes, legacy.csAssertions, replay.csAssertions, legacy.timeNs / 1e6, replay.timeNs / 1e6);
+        return same;
+    }
+
+    const char* const FORMAT_NAMES[] = {"12bpp", "16bpp", "18bpp"};
+    const char* const ORDER_NAMES[] = {"RGB", "BGR"};
+
+    // xorshift32, reproducible from the seed
+    unsigned int NextRandom(unsigned int* state) {
+        unsigned int x = *state;
+        x ^= x << 13U;
+        x ^= x >> 17U;
+        x ^= x << 5U;
+        *state = x;
+        return x;
+    }
+
+    void RandomBytes(unsigned int* state, std::vector<unsigned char>& bytes) {
+        for (size_t i = 0U; i < bytes.size(); ++i) {
+            bytes[i] = NextRandom(state) >> 24U;
+        }
+    }
+
+    // Bits per channel on the wire, in source order (R, G, B)
+    unsigned int ChannelBits(PixelFormat pf, unsigned int channel) {
+        return (PF12BitsPerPixel == pf) ? 4U : ((PF16BitsPerPixel == pf) ? ((1U == channel) ? 6U : 5U) : 6U);
+    }
+
+    /* Reference encoder, written straight from the wire formats and kept free of any trick: levels holds the
+     * quantized R, G, B of every pixel, they are reordered and packed one pixel at a time.
+     * */
+    std::vector<unsigned char> Pack(PixelFormat pf, ColorOrder order, const std::vector<unsigned int>& levels) {
+        std::vector<unsigned char> out;
+        const size_t pixelCount = levels.size() / 3U;
+        for (size_t i = 0U; i < pixelCount; ++i) {
+            const unsigned int r = levels[i * 3U];
+            const unsigned int g = levels[i * 3U + 1U];
+            const unsigned int b = levels[i * 3U + 2U];
+            const unsigned int first = (ColorOrderRGB == order) ? r : b;
+            const unsigned int last = (ColorOrderRGB == order) ? b : r;
+            switch (pf)
+            {
+            case PF12BitsPerPixel:
+                // RRRRGGGG BBBBRRRR GGGGBBBB, an odd last pixel ends as RRRRGGGG BBBB0000
+                if (0U == (i & 1U)) {
+                    out.push_back((first << 4U) | g);
+                    out.push_back(last << 4U);
+                } else {
+                    out.back() |= first;
+                    out.push_back((g << 4U) | last);
+                }
+                break;
+            case PF16BitsPerPixel:
+                // RRRRRGGG GGGBBBBB
+                out.push_back((first << 3U) | (g >> 3U));
+                out.push_back(((g & 0x07U) << 5U) | last);
+                break;
+            default:
+                // RRRRRR00 GGGGGG00 BBBBBB00
+                out.push_back(first << 2U);
+                out.push_back(g << 2U);
+                out.push_back(last << 2U);
+                break;
+            }
+        }
+        return out;
+    }
+
+    // Plain conversion: the high bits of every channel
+    std::vector<unsigned int> Truncate(PixelFormat pf, const unsigned char rgb[], size_t pixelCount) {
+        std::vector<unsigned int> levels(pixelCount * 3U);
+        for (size_t i = 0U; i < levels.size(); ++i) {
+            levels[i] = rgb[i] >> (8U - ChannelBits(pf, i % 3U));
+        }
+        return levels;
+    }
+
+    // Ordered dither of a run starting at cursor: scale to the levels, add the Bayer threshold, truncate
+    std::vector<unsigned int> Dither(PixelFormat pf, const unsigned char rgb[], size_t pixelCount, GC9A01Kernels::Cursor cursor) {
+        static const unsigned int BAYER[4U][4U] = {{0U, 8U, 2U, 10U}, {12U, 4U, 14U, 6U}, {3U, 11U, 1U, 9U}, {15U, 7U, 13U, 5U}};
+        std::vector<unsigned int> levels(pixelCount * 3U);
+        for (size_t i = 0U; i < pixelCount; ++i) {
+            const unsigned int threshold = BAYER[cursor.y % 4U][cursor.x % 4U];
+            for (unsigned int c = 0U; c < 3U; ++c) {
+                const unsigned int bits = ChannelBits(pf, c);
+                const unsigned int step = 1U << (8U - bits);
+                const unsigned int scaled = (rgb[i * 3U + c] * ((1U << bits) - 1U) * step + 127U) / 255U;
+                levels[i * 3U + c] = (scaled + (threshold * step) / 16U) / step;
+            }
+            if (cursor.x == cursor.x1) {
+                cursor.x = cursor.x0;
+                ++cursor.y;
+            } else {
+                ++cursor.x;
+            }
+        }
+        return levels;
+    }
+
+    // Color table at gamma 1: channel * brightness / 255 rounded to the nearest level
+    std::vector<unsigned int> Scale(PixelFormat pf, const unsigned char rgb[], size_t pixelCount, unsigned char brightness) {
+        std::vector<unsigned int> levels(pixelCount * 3U);
+        for (size_t i = 0U; i < levels.size(); ++i) {
+            const unsigned int maxLevel = (1U << ChannelBits(pf, i % 3U)) - 1U;
+            levels[i] = static_cast<unsigned int>(((rgb[i] / 255.0) * brightness * maxLevel) / 255.0 + 0.5);
+        }
+        return levels;
+    }
+
+    // Reports the first difference, true when out matches expected
+    bool Check(const char* what, PixelFormat pf, ColorOrder order, size_t pixelCount, const unsigned char out[], size_t outSize,
+               const std::vector<unsigned char>& expected) {
+        if (outSize != expected.size()) {
+            printf("%s %s %s, %zu pixels: %zu bytes instead of %zu\n", what, FORMAT_NAMES[pf], ORDER_NAMES[order], pixelCount, outSize, expected.size());
+            return false;
+        }
+        for (size_t i = 0U; i < outSize; ++i) {
+            if (out[i] != expected[i]) {
+                printf("%s %s %s, %zu pixels: byte %zu is 0x%02X instead of 0x%02X\n", what, FORMAT_NAMES[pf], ORDER_NAMES[order], pixelCount, i,
+                       out[i], expected[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Pixel payload (MemoryWrite and WriteMemoryContinue data) of a command log, in order
+    std::vector<unsigned char> Payload(const std::vector<GC9A01LoggedCommand>& log) {
+        std::vector<unsigned char> payload;
+        for (size_t i = 0U; i < log.size(); ++i) {
+            if ((RegulativeCommandSet::MemoryWrite == log[i].command) || (RegulativeCommandSet::WriteMemoryContinue == log[i].command)) {
+                payload.insert(payload.end(), log[i].data.begin(), log[i].data.end());
+            }
+        }
+        return payload;
+    }
+
+    // Source of WritePixels: the next pixels of an RGB888 buffer
+    typedef struct {
+        const unsigned char* rgb;
+        size_t position;
+    } BufferSource;
+
+    void ReadBuffer(void* context, size_t pixelCount, unsigned char rgb[]) {
+        BufferSource* const source = static_cast<BufferSource*>(context);
+        memcpy(rgb, &source->rgb[source->position * RGB_COUNT], pixelCount * RGB_COUNT);
+        source->position += pixelCount;
+    }
+}
+
+namespace GC9A01Diagnostics {
+    bool CompareInitSequences(const GC9A01& display, GC9A01Emulator& emulator) {
+        bool same = true;
+        same = Compare("Init", Record(emulator, &LegacyInit, display), Record(emulator, [](const GC9A01& d) { d.Init(); }, display)) && same;
+        same = Compare("Adafruit_Init", Record(emulator, &LegacyAdafruitInit, display), Record(emulator, [](const GC9A01& d) { d.Adafruit_Init(); }, display)) && same;
+        return same;
+    }
+
+    bool CheckResetTracking(const GC9A01& display, GC9A01Emulator& emulator) {
+        static const char* const RESET_NAMES[] = {"software reset", "hardware reset"};
+        bool same = true;
+        for (unsigned int kind = 0U; kind < 2U; ++kind) {
+            display.Init();
+            if (0U == kind) {
+                display.WriteCycleSequence(0x01, nullptr, 0);
+            } else {
+                display.HardwareReset();
+            }
+            emulator.ClearLog();
+            emulator.SetLogEnabled(true);
+            display.SetPixelFormat(PF12BitsPerPixel);
+            const std::vector<GC9A01LoggedCommand> log = emulator.GetLog();
+            emulator.SetLogEnabled(false);
+            emulator.ClearLog();
+
+            const bool sent = (1U == log.size()) && (RegulativeCommandSet::COLMODPixelFormatSet == log[0].command);
+            const bool ok = sent && (PF12BitsPerPixel == display.GetPixelFormat()) &&
+                            ((COLMOD::DPI18BitPerPixel | COLMOD::DBI12BitPerPixel) == emulator.GetCOLMOD());
+            printf("%-14s %s  COLMOD %s, panel at 0x%02X\n", RESET_NAMES[kind], ok ? "same" : "DIFF", sent ? "sent" : "not sent", emulator.GetCOLMOD());
+            same = ok && same;
+        }
+        display.Init();
+        return same;
+    }
+
+    bool FuzzConversions(GC9A01& display, GC9A01Emulator& emulator, unsigned int iterations, unsigned int seed) {
+        unsigned int state = (0U == seed) ? 1U : seed;
+        const PixelFormat previousFormat = display.GetPixelFormat();
+        const ColorOrder previousOrder = display.GetColorOrder();
+        // Room for misaligned starts
+        std::vector<unsigned char> rgb(4U + 600U * RGB_COUNT);
+        std::vector<unsigned char> out(4U + 600U * RGB_COUNT);
+        unsigned long long failures[4U] = {0U, 0U, 0U, 0U};
+        unsigned long long cases = 0U;
+
+        for (int pf = PF12BitsPerPixel; pf <= PF18BitsPerPixel; ++pf) {
+            for (int order = ColorOrderRGB; order <= ColorOrderBGR; ++order) {
+                const PixelFormat format = static_cast<PixelFormat>(pf);
+                const ColorOrder colorOrder = static_cast<ColorOrder>(order);
+                const GC9A01Kernels::ConvertFunction convert = GC9A01Kernels::Select(format, colorOrder);
+                const GC9A01Kernels::DitherFunction ditherConvert = GC9A01Kernels::SelectDithered(format, colorOrder);
+
+                for (unsigned int iteration = 0U; iteration < iterations; ++iteration) {
+                    const size_t pixelCount = NextRandom(&state) % 600U;
+                    const size_t inOffset = NextRandom(&state) % 4U;
+                    const size_t outOffset = NextRandom(&state) % 4U;
+                    RandomBytes(&state, rgb);
+                    const unsigned char* const in = &rgb[inOffset];
+                    ++cases;
+
+                    // Word kernels on aligned and misaligned buffers
+                    const std::vector<unsigned char> plain = Pack(format, colorOrder, Truncate(format, in, pixelCount));
+                    size_t outSize = convert(in, pixelCount, &out[outOffset]);
+                    failures[0] += Check("kernel", format, colorOrder, pixelCount, &out[outOffset], outSize, plain) ? 0U : 1U;
+
+                    // In place, as WritePixels converts
+                    memcpy(&out[inOffset], in, pixelCount * RGB_COUNT);
+                    outSize = convert(&out[inOffset], pixelCount, &out[inOffset]);
+                    failures[0] += Check("in place kernel", format, colorOrder, pixelCount, &out[inOffset], outSize, plain) ? 0U : 1U;
+
+                    // Dither from a random position of a random rectangle
+                    GC9A01Kernels::Cursor cursor;
+                    cursor.x0 = NextRandom(&state) % MAX_WIDTH;
+                    cursor.x1 = cursor.x0 + NextRandom(&state) % (MAX_WIDTH - cursor.x0);
+                    cursor.x = cursor.x0 + NextRandom(&state) % (cursor.x1 - cursor.x0 + 1U);
+                    cursor.y = NextRandom(&state) % MAX_HEIGHT;
+                    const std::vector<unsigned char> dithered = Pack(format, colorOrder, Dither(format, in, pixelCount, cursor));
+                    GC9A01Kernels::Cursor inPlaceCursor = cursor;
+                    outSize = ditherConvert(in, pixelCount, &out[outOffset], &cursor);
+                    failures[1] += Check("dither kernel", format, colorOrder, pixelCount, &out[outOffset], outSize, dithered) ? 0U : 1U;
+                    memcpy(&out[inOffset], in, pixelCount * RGB_COUNT);
+                    outSize = ditherConvert(&out[inOffset], pixelCount, &out[inOffset], &inPlaceCursor);
+                    failures[1] += Check("in place dither kernel", format, colorOrder, pixelCount, &out[inOffset], outSize, dithered) ? 0U : 1U;
+
+                    // Color table, every few cases as building one is slow
+                    if (0U == (iteration % 16U)) {
+                        const unsigned char brightness = NextRandom(&state) >> 24U;
+                        const GC9A01Kernels::ColorLut lut(format, colorOrder, 1.0, brightness);
+                        const std::vector<unsigned char> scaled = Pack(format, colorOrder, Scale(format, in, pixelCount, brightness));
+                        outSize = GC9A01Kernels::ConvertWithLut(lut, in, pixelCount, &out[outOffset]);
+                        failures[2] += Check("color table", format, colorOrder, pixelCount, &out[outOffset], outSize, scaled) ? 0U : 1U;
+                        memcpy(&out[inOffset], in, pixelCount * RGB_COUNT);
+                        outSize = GC9A01Kernels::ConvertWithLut(lut, &out[inOffset], pixelCount, &out[inOffset]);
+                        failures[2] += Check("in place color table", format, colorOrder, pixelCount, &out[inOffset], outSize, scaled) ? 0U : 1U;
+                    }
+                }
+
+                // Through the driver: the payload the panel receives for odd sized rectangles, plain, dithered and through a
+                // color table, for images, pixel sources and solid fills (repeat pattern DMA)
+                static const char* const PATH_NAMES[] = {"FillImage", "WritePixels", "FillArea"};
+                static const char* const MODE_NAMES[] = {"", " dithered", " color table"};
+                const unsigned char brightness = NextRandom(&state) >> 24U;
+                const GC9A01Kernels::ColorLut lut(format, colorOrder, 1.0, brightness);
+                display.SetPixelFormat(format);
+                display.SetColorOrder(colorOrder);
+                for (unsigned int iteration = 0U; iteration < (iterations / 8U + 1U); ++iteration) {
+                    const unsigned short w = 1U + NextRandom(&state) % 40U;
+                    const unsigned short h = 1U + NextRandom(&state) % 15U;
+                    const unsigned short x0 = NextRandom(&state) % (MAX_WIDTH - w + 1U);
+                    const unsigned short y0 = NextRandom(&state) % (MAX_HEIGHT - h + 1U);
+                    const unsigned int path = NextRandom(&state) % 3U;
+                    const unsigned int mode = NextRandom(&state) % 3U;
+                    const size_t pixelCount = w * h;
+                    RandomBytes(&state, rgb);
+                    if (2U == path) {
+                        // The fill color in every pixel, as the reference sees it
+                        for (size_t i = 1U; i < pixelCount; ++i) {
+                            memcpy(&rgb[i * RGB_COUNT], rgb.data(), RGB_COUNT);
+                        }
+                    }
+                    ++cases;
+
+                    display.SetDither(1U == mode);
+                    display.SetColorLut((2U == mode) ? &lut : nullptr);
+                    emulator.SetLogEnabled(true);
+                    if (0U == path) {
+                        display.FillImage(rgb.data(), x0, y0, w, h);
+                    } else if (1U == path) {
+                        BufferSource source = {rgb.data(), 0U};
+                        display.WritePixels(x0, y0, w, h, &ReadBuffer, &source);
+                    } else {
+                        display.FillArea(rgb[0], rgb[1], rgb[2], x0, y0, w, h);
+                    }
+                    std::vector<unsigned char> payload = Payload(emulator.GetLog());
+                    emulator.SetLogEnabled(false);
+                    display.SetDither(false);
+                    display.SetColorLut(nullptr);
+
+                    if ((2U == path) && (PF12BitsPerPixel == format) && (0U != (pixelCount & 1U)) && !payload.empty()) {
+                        // The repeated pixel pair ends an odd fill with the first half of the next pair instead of zeros,
+                        // the panel drops that padding nibble
+                        payload.back() &= 0xF0U;
+                    }
+                    std::vector<unsigned int> levels;
+                    if (2U == mode) {
+                        levels = Scale(format, rgb.data(), pixelCount, brightness);
+                    } else if ((1U == mode) && (2U != path)) {
+                        // Solid fills are never dithered
+                        GC9A01Kernels::Cursor cursor;
+                        cursor.x0 = x0;
+                        cursor.x1 = x0 + w - 1U;
+                        cursor.x = x0;
+                        cursor.y = y0;
+                        levels = Dither(format, rgb.data(), pixelCount, cursor);
+                    } else {
+                        levels = Truncate(format, rgb.data(), pixelCount);
+                    }
+                    const std::vector<unsigned char> expected = Pack(format, colorOrder, levels);
+                    char what[32];
+                    snprintf(what, sizeof(what), "%s%s", PATH_NAMES[path], MODE_NAMES[mode]);
+                    failures[3] += Check(what, format, colorOrder, pixelCount, payload.data(), payload.size(), expected) ? 0U : 1U;
+                }
+            }
+        }
+        display.SetPixelFormat(previousFormat);
+        display.SetColorOrder(previousOrder);
+
+        printf("fuzz seed %u: %llu cases, failures: kernel %llu, dither %llu, color table %llu, driver %llu\n", seed, cases, failures[0],
+               failures[1], failures[2], failures[3]);
+        return 0U == (failures[0] + failures[1] + failures[2] + failures[3]);
+    }
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef GC9A01_DIAGNOSTICS_HPP
+#define GC9A01_DIAGNOSTICS_HPP
+
+#ifdef GC9A01_HOST
+
+#include "GC9A01.hpp"
+#include "GC9A01_Emulator.hpp"
+
+/* Host only checks of the driver against the GC9A01Emulator. They print what they find and return
+ * true when everything matches, so they can be called from any host program.
+ * */
+namespace GC9A01Diagnostics {
+    /* Runs the former per command Init() / Adafruit_Init() and the command list replay on display (which has
+     * to drive emulator) and compares the decoded command streams byte for byte. CS assertions and boot time
+     * of both are printed. The former sequences are kept as they were except for the TE command, which carries
+     * the intended 35h instead of the original 34h (see GC9A01CommandLists).
+     * */
+    bool CompareInitSequences(const GC9A01& display, GC9A01Emulator& emulator);
+    /* Software (01h) and hardware reset after Init(): the panel is back to COLMOD 66h, so SetPixelFormat(PF12BitsPerPixel)
+     * has to send COLMODPixelFormatSet again and the panel has to end at 12 bits per pixel.
+     * */
+    bool CheckResetTracking(const GC9A01& display, GC9A01Emulator& emulator);
+    /* Differential fuzzing of the pixel conversion: random RGB888 runs of random (often odd) length, on aligned and
+     * misaligned buffers and in place, go through every kernel for each PixelFormat and color order (plain, dithered
+     * from a random position, color table) and through FillImage / WritePixels / FillArea on display for random odd
+     * sized rectangles, plain, with SetDither and with SetColorLut. Every output is compared byte for byte with a
+     * scalar reference encoder written from the wire formats (but for the padding nibble of an odd 12 bit fill). The
+     * first difference of each failing case is printed.
+     *
+     * @param seed runs are reproducible from it
+     * */
+    bool FuzzConversions(GC9A01& display, GC9A01Emulator& emulator, unsigned int iterations = 1000U, unsigned int seed = 1U);
+}
+
+#endif
+
+#endif
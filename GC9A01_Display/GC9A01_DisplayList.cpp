@@ -0,0 +1,314 @@
+#include <string.h>
+#include "GC9A01_DisplayList.hpp"
+#include "GC9A01_Font.hpp"
+#include "GC9A01_Trig.hpp"
+
+GC9A01DisplayList::GC9A01DisplayList(const GC9A01& display, unsigned char buffer[], size_t bufferSize)
+ : display(display), renderer(display, buffer, bufferSize), damage(display), primitives(display), count(0U), lastRects(0U), lastPixels(0U) {
+    this->InvalidateAll();
+}
+
+size_t GC9A01DisplayList::Add(DisplayNodeType type, unsigned short x, unsigned short y, unsigned char r, unsigned char g, unsigned char b) {
+    if (GC9A01_MAX_DISPLAY_NODES == this->count) {
+        return INVALID_NODE;
+    }
+    Node& node = this->nodes[this->count];
+    memset(&node, 0, sizeof(node));
+    node.type = type;
+    node.visible = true;
+    node.x = x;
+    node.y = y;
+    node.color[0] = r;
+    node.color[1] = g;
+    node.color[2] = b;
+    node.scale = 1U;
+    // Differs from drawnVersion, the node is drawn by the next Render
+    node.version = 1U;
+    ++this->count;
+    return this->count - 1U;
+}
+
+size_t GC9A01DisplayList::AddRect(unsigned short x, unsigned short y, unsigned short w, unsigned short h, unsigned char r, unsigned char g, unsigned char b) {
+    const size_t node = this->Add(DisplayNodeRect, x, y, r, g, b);
+    if (INVALID_NODE != node) {
+        this->nodes[node].w = w;
+        this->nodes[node].h = h;
+    }
+    return node;
+}
+
+size_t GC9A01DisplayList::AddText(unsigned short x, unsigned short y, const char* text, unsigned char r, unsigned char g, unsigned char b, unsigned char scale) {
+    const size_t node = this->Add(DisplayNodeText, x, y, r, g, b);
+    if (INVALID_NODE != node) {
+        this->nodes[node].data = text;
+        this->nodes[node].scale = scale;
+    }
+    return node;
+}
+
+size_t GC9A01DisplayList::AddImage(unsigned short x, unsigned short y, unsigned short w, unsigned short h, const unsigned char image[]) {
+    const size_t node = this->Add(DisplayNodeImage, x, y, 0U, 0U, 0U);
+    if (INVALID_NODE != node) {
+        this->nodes[node].w = w;
+        this->nodes[node].h = h;
+        this->nodes[node].data = image;
+    }
+    return node;
+}
+
+size_t GC9A01DisplayList::AddArc(unsigned short cx, unsigned short cy, unsigned short radius, unsigned short thickness, short startAngle, short endAngle,
+                                 unsigned char r, unsigned char g, unsigned char b) {
+    const size_t node = this->Add(DisplayNodeArc, cx, cy, r, g, b);
+    if (INVALID_NODE != node) {
+        this->nodes[node].radius = radius;
+        this->nodes[node].thickness = thickness;
+        this->nodes[node].startAngle = startAngle;
+        this->nodes[node].endAngle = endAngle;
+    }
+    return node;
+}
+
+void GC9A01DisplayList::SetPosition(size_t node, unsigned short x, unsigned short y) {
+    if ((x != this->nodes[node].x) || (y != this->nodes[node].y)) {
+        this->nodes[node].x = x;
+        this->nodes[node].y = y;
+        this->Touch(node);
+    }
+}
+
+void GC9A01DisplayList::SetSize(size_t node, unsigned short w, unsigned short h) {
+    if ((w != this->nodes[node].w) || (h != this->nodes[node].h)) {
+        this->nodes[node].w = w;
+        this->nodes[node].h = h;
+        this->Touch(node);
+    }
+}
+
+void GC9A01DisplayList::SetColor(size_t node, unsigned char r, unsigned char g, unsigned char b) {
+    unsigned char* const color = this->nodes[node].color;
+    if ((r != color[0]) || (g != color[1]) || (b != color[2])) {
+        color[0] = r;
+        color[1] = g;
+        color[2] = b;
+        this->Touch(node);
+    }
+}
+
+void GC9A01DisplayList::SetVisible(size_t node, bool visible) {
+    if (visible != this->nodes[node].visible) {
+        this->nodes[node].visible = visible;
+        this->Touch(node);
+    }
+}
+
+void GC9A01DisplayList::SetText(size_t node, const char* text) {
+    // Always a change, the caller may have rewritten the same buffer
+    this->nodes[node].data = text;
+    this->Touch(node);
+}
+
+void GC9A01DisplayList::SetImage(size_t node, const unsigned char image[]) {
+    this->nodes[node].data = image;
+    this->Touch(node);
+}
+
+void GC9A01DisplayList::SetArcAngles(size_t node, short startAngle, short endAngle) {
+    if ((startAngle != this->nodes[node].startAngle) || (endAngle != this->nodes[node].endAngle)) {
+        this->nodes[node].startAngle = startAngle;
+        this->nodes[node].endAngle = endAngle;
+        this->Touch(node);
+    }
+}
+
+void GC9A01DisplayList::InvalidateAll() {
+    this->damage.Add(0U, 0U, MAX_WIDTH, MAX_HEIGHT, MAX_WIDTH, MAX_HEIGHT);
+}
+
+void GC9A01DisplayList::SetBackground(unsigned char r, unsigned char g, unsigned char b) {
+    this->renderer.SetBackground(r, g, b);
+    this->InvalidateAll();
+}
+
+bool GC9A01DisplayList::GetBounds(const Node& node, Rect* bounds) const {
+    int x0 = node.x;
+    int y0 = node.y;
+    int w = node.w;
+    int h = node.h;
+    switch (node.type)
+    {
+    case DisplayNodeText:
+        w = GC9A01Font::GetTextWidth(strlen(static_cast<const char*>(node.data)), node.scale);
+        h = GC9A01Font::HEIGHT * node.scale;
+        break;
+    case DisplayNodeArc:
+    {
+        int sweep = node.endAngle - node.startAngle;
+        if (sweep < 0) {
+            sweep = (sweep % 360) + 360;
+        }
+        if (0 == sweep) {
+            return false;
+        }
+        const int r = node.radius;
+        if (sweep >= 360) {
+            x0 = node.x - r;
+            y0 = node.y - r;
+            w = 2 * r + 1;
+            h = w;
+            break;
+        }
+        // Box of both ends of the arc, grown to every axis the arc crosses, plus a pixel for rounding
+        const int inner = (r > node.thickness) ? (r - node.thickness) : 0;
+        int left = 0;
+        int top = 0;
+        int right = 0;
+        int bottom = 0;
+        bool first = true;
+        for (int end = 0; end < 2; ++end) {
+            const unsigned short angle = GC9A01Trig::FromDegrees(node.startAngle + end * sweep);
+            const int dx = GC9A01Trig::Sin(angle);
+            const int dy = -GC9A01Trig::Cos(angle);
+            for (int radius = inner; ; radius = r) {
+                const int px = (dx * radius) / GC9A01Trig::ONE;
+                const int py = (dy * radius) / GC9A01Trig::ONE;
+                left = (first || (px < left)) ? px : left;
+                right = (first || (px > right)) ? px : right;
+                top = (first || (py < top)) ? py : top;
+                bottom = (first || (py > bottom)) ? py : bottom;
+                first = false;
+                if (radius == r) {
+                    break;
+                }
+            }
+        }
+        int start = node.startAngle % 360;
+        start = (start < 0) ? (start + 360) : start;
+        for (int axis = 0; axis < 720; axis += 90) {
+            if ((axis > start) && (axis < (start + sweep))) {
+                switch ((axis / 90) % 4)
+                {
+                case 0:
+                    top = -r;
+                    break;
+                case 1:
+                    right = r;
+                    break;
+                case 2:
+                    bottom = r;
+                    break;
+                default:
+                    left = -r;
+                    break;
+                }
+            }
+        }
+        x0 = node.x + left - 1;
+        y0 = node.y + top - 1;
+        w = right - left + 3;
+        h = bottom - top + 3;
+        break;
+    }
+    default:
+        break;
+    }
+    const int x1 = ((x0 + w) < static_cast<int>(MAX_WIDTH)) ? (x0 + w) : MAX_WIDTH;
+    const int y1 = ((y0 + h) < static_cast<int>(MAX_HEIGHT)) ? (y0 + h) : MAX_HEIGHT;
+    x0 = (x0 > 0) ? x0 : 0;
+    y0 = (y0 > 0) ? y0 : 0;
+    if ((x0 >= x1) || (y0 >= y1)) {
+        return false;
+    }
+    bounds->x0 = x0;
+    bounds->y0 = y0;
+    bounds->x1 = x1 - 1;
+    bounds->y1 = y1 - 1;
+    return true;
+}
+
+void GC9A01DisplayList::DrawNode(const Node& node, GC9A01Band& band) const {
+    switch (node.type)
+    {
+    case DisplayNodeRect:
+        band.FillRect(node.x, node.y, node.w, node.h, node.color[0], node.color[1], node.color[2]);
+        break;
+    case DisplayNodeText:
+    {
+        const unsigned short size = node.scale;
+        unsigned short x = node.x;
+        for (const char* c = static_cast<const char*>(node.data); '\0' != *c; ++c, x += GC9A01Font::ADVANCE * size) {
+            const unsigned char* const glyph = GC9A01Font::GetGlyph(*c);
+            for (unsigned short column = 0U; column < GC9A01Font::WIDTH; ++column) {
+                // Each vertical run of set bits is one rectangle
+                unsigned short row = 0U;
+                while (row < GC9A01Font::HEIGHT) {
+                    if (0U == (glyph[column] & (1U << row))) {
+                        ++row;
+                        continue;
+                    }
+                    const unsigned short first = row;
+                    while ((row < GC9A01Font::HEIGHT) && (0U != (glyph[column] & (1U << row)))) {
+                        ++row;
+                    }
+                    band.FillRect(x + column * size, node.y + first * size, size, (row - first) * size, node.color[0], node.color[1], node.color[2]);
+                }
+            }
+        }
+        break;
+    }
+    case DisplayNodeImage:
+        band.DrawImage(static_cast<const unsigned char*>(node.data), node.x, node.y, node.w, node.h);
+        break;
+    default:
+        this->primitives.SetBand(&band);
+        this->primitives.SetColor(node.color[0], node.color[1], node.color[2]);
+        this->primitives.DrawArc(node.x, node.y, node.radius, node.thickness, node.startAngle, node.endAngle);
+        this->primitives.SetBand(nullptr);
+        break;
+    }
+}
+
+void GC9A01DisplayList::DrawBand(void* context, GC9A01Band& band) {
+    const GC9A01DisplayList* const list = static_cast<const GC9A01DisplayList*>(context);
+    for (size_t i = 0U; i < list->count; ++i) {
+        const Node& node = list->nodes[i];
+        // drawnBounds is where the node is now, Render has just updated it
+        if (node.drawn && band.Intersects(node.drawnBounds.x0, node.drawnBounds.y0, node.drawnBounds.x1 - node.drawnBounds.x0 + 1U,
+                                          node.drawnBounds.y1 - node.drawnBounds.y0 + 1U)) {
+            list->DrawNode(node, band);
+        }
+    }
+}
+
+void GC9A01DisplayList::Render() {
+    // Damage: where changed nodes were and where they are now
+    for (size_t i = 0U; i < this->count; ++i) {
+        Node& node = this->nodes[i];
+        if (node.version == node.drawnVersion) {
+            continue;
+        }
+        if (node.drawn) {
+            this->damage.Add(node.drawnBounds.x0, node.drawnBounds.y0, node.drawnBounds.x1 - node.drawnBounds.x0 + 1U,
+                             node.drawnBounds.y1 - node.drawnBounds.y0 + 1U, MAX_WIDTH, MAX_HEIGHT);
+        }
+        node.drawn = node.visible && this->GetBounds(node, &node.drawnBounds);
+        if (node.drawn) {
+            this->damage.Add(node.drawnBounds.x0, node.drawnBounds.y0, node.drawnBounds.x1 - node.drawnBounds.x0 + 1U,
+                             node.drawnBounds.y1 - node.drawnBounds.y0 + 1U, MAX_WIDTH, MAX_HEIGHT);
+        }
+        node.drawnVersion = node.version;
+    }
+
+    this->lastRects = this->damage.GetCount();
+    this->lastPixels = 0U;
+    this->damage.Sort();
+    this->display.BeginTransaction();
+    for (size_t i = 0U; i < this->damage.GetCount(); ++i) {
+        const Rect& rect = this->damage.Get(i);
+        const unsigned short w = rect.x1 - rect.x0 + 1U;
+        const unsigned short h = rect.y1 - rect.y0 + 1U;
+        this->renderer.Render(&GC9A01DisplayList::DrawBand, this, rect.x0, rect.y0, w, h);
+        this->lastPixels += w * h;
+    }
+    this->display.EndTransaction();
+    this->damage.Clear();
+}
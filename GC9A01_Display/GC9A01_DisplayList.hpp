@@ -0,0 +1,110 @@
+#ifndef GC9A01_DISPLAY_LIST_HPP
+#define GC9A01_DISPLAY_LIST_HPP
+
+#include "GC9A01.hpp"
+#include "GC9A01_BandRenderer.hpp"
+#include "GC9A01_FrameBuffer.hpp"
+#include "GC9A01_Primitives.hpp"
+
+// Nodes a display list holds
+#ifndef GC9A01_MAX_DISPLAY_NODES
+#define GC9A01_MAX_DISPLAY_NODES 32U
+#endif
+
+/* Retained scene of rectangles, text (GC9A01Font), RGB888 images and arcs, painted in the order they were added.
+ *
+ * Every change to a node bumps its version. Render() compares each node with the version it last drew: the area
+ * it covered then and the area it covers now become damage (merged as GC9A01DirtyRects does for framebuffers), and
+ * only the damaged rectangles are rendered band by band (see GC9A01BandRenderer) and sent. Every node overlapping a
+ * damaged rectangle is painted into it, so whatever lies under or over a changed node stays right.
+ *
+ * Text and image data belong to the caller and have to stay valid. Call Invalidate() after changing them in place.
+ * */
+class GC9A01DisplayList
+{
+public:
+    typedef enum {
+        DisplayNodeRect,
+        DisplayNodeText,
+        DisplayNodeImage,
+        DisplayNodeArc
+    } DisplayNodeType;
+    // Returned by the Add calls when the list is full
+    static constexpr size_t INVALID_NODE = static_cast<size_t>(-1);
+    typedef GC9A01DirtyRects::Rect Rect;
+private:
+    typedef struct {
+        DisplayNodeType type;
+        bool visible;
+        // Top left corner (the center for arcs)
+        unsigned short x;
+        unsigned short y;
+        // Size of rectangles and images
+        unsigned short w;
+        unsigned short h;
+        unsigned char color[RGB_COUNT];
+        // Text or image
+        const void* data;
+        unsigned char scale;
+        unsigned short radius;
+        unsigned short thickness;
+        short startAngle;
+        short endAngle;
+        unsigned int version;
+        unsigned int drawnVersion;
+        // Area painted by the last Render, if any
+        bool drawn;
+        Rect drawnBounds;
+    } Node;
+
+    const GC9A01& display;
+    GC9A01BandRenderer renderer;
+    GC9A01DirtyRects damage;
+    // Draws the arcs into the band being rendered
+    mutable GC9A01Primitives primitives;
+    Node nodes[GC9A01_MAX_DISPLAY_NODES];
+    size_t count;
+    size_t lastRects;
+    size_t lastPixels;
+
+    size_t Add(DisplayNodeType type, unsigned short x, unsigned short y, unsigned char r, unsigned char g, unsigned char b);
+    inline void Touch(size_t node) { ++this->nodes[node].version; }
+    // Screen area of node, false when it covers nothing
+    bool GetBounds(const Node& node, Rect* bounds) const;
+    void DrawNode(const Node& node, GC9A01Band& band) const;
+    static void DrawBand(void* context, GC9A01Band& band);
+public:
+    // @param buffer band buffer for GC9A01BandRenderer, at least MAX_WIDTH * RGB_COUNT bytes
+    GC9A01DisplayList(const GC9A01& display, unsigned char buffer[], size_t bufferSize);
+    size_t AddRect(unsigned short x, unsigned short y, unsigned short w, unsigned short h, unsigned char r, unsigned char g, unsigned char b);
+    // text stays owned by the caller, scale 1 gives 5x7 pixel characters
+    size_t AddText(unsigned short x, unsigned short y, const char* text, unsigned char r, unsigned char g, unsigned char b, unsigned char scale = 1U);
+    // RGB888 image of w x h pixels, owned by the caller
+    size_t AddImage(unsigned short x, unsigned short y, unsigned short w, unsigned short h, const unsigned char image[]);
+    // Ring part as GC9A01Primitives::DrawArc draws it
+    size_t AddArc(unsigned short cx, unsigned short cy, unsigned short radius, unsigned short thickness, short startAngle, short endAngle,
+                  unsigned char r, unsigned char g, unsigned char b);
+    inline size_t GetCount() const { return this->count; }
+    inline unsigned int GetVersion(size_t node) const { return this->nodes[node].version; }
+
+    void SetPosition(size_t node, unsigned short x, unsigned short y);
+    void SetSize(size_t node, unsigned short w, unsigned short h);
+    void SetColor(size_t node, unsigned char r, unsigned char g, unsigned char b);
+    void SetVisible(size_t node, bool visible);
+    void SetText(size_t node, const char* text);
+    void SetImage(size_t node, const unsigned char image[]);
+    void SetArcAngles(size_t node, short startAngle, short endAngle);
+    // The text or image of node changed in place
+    inline void Invalidate(size_t node) { this->Touch(node); }
+    // Redraws the whole screen at the next Render, the background included
+    void InvalidateAll();
+    void SetBackground(unsigned char r, unsigned char g, unsigned char b);
+
+    // Renders and sends the damage collected since the last call
+    void Render();
+    // Rectangles and pixels sent by the last Render
+    inline size_t GetLastRects() const { return this->lastRects; }
+    inline size_t GetLastPixels() const { return this->lastPixels; }
+};
+
+#endif
@@ -0,0 +1,304 @@
+#ifdef GC9A01_HOST
+
+#include <chrono>
+#include <string.h>
+#include "GC9A01_Emulator.hpp"
+
+static unsigned long long SteadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+GC9A01Emulator::GC9A01Emulator(unsigned char cs_pin, unsigned char rst_pin, unsigned char dc_pin)
+ : cs_pin(cs_pin), dc_pin(dc_pin), rst_pin(rst_pin), csLevel(ON), dcLevel(ON), rstLevel(ON), spiClockHz(40U * 1000U * 1000U),
+   startNs(SteadyNowNs()), offsetNs(0U), busFreeAtNs(0U), logEnabled(false), framePeriodNs(1000000000ULL / 60U) {
+    memset(this->gram, 0, sizeof(this->gram));
+    this->ResetRegisters();
+    this->ResetStats();
+}
+
+GC9A01Emulator::~GC9A01Emulator() { }
+
+void GC9A01Emulator::ResetRegisters() {
+    // Power on / reset defaults from the datasheet
+    this->command = 0x00U;
+    this->parameterIndex = 0U;
+    this->colmod = COLMOD::DPI18BitPerPixel | COLMOD::DBI18BitPerPixel;
+    this->madctl = 0x00U;
+    this->columnStart = 0U;
+    this->columnEnd = MAX_WIDTH - 1U;
+    this->rowStart = 0U;
+    this->rowEnd = MAX_HEIGHT - 1U;
+    this->column = 0U;
+    this->row = 0U;
+    this->pixelByteCount = 0U;
+    this->tearingEffectOn = false;
+    this->tearLine = FIRST_GATE_LINE + MAX_HEIGHT;
+}
+
+void GC9A01Emulator::ResetStats() {
+    memset(&this->stats, 0, sizeof(this->stats));
+}
+
+void GC9A01Emulator::SetLogEnabled(bool enabled) {
+    this->logEnabled = enabled;
+    if (!enabled) {
+        this->log.clear();
+    }
+}
+
+unsigned long long GC9A01Emulator::WireTimeNs(size_t dataSize) const {
+    return (dataSize * 8ULL * 1000000000ULL) / this->spiClockHz;
+}
+
+unsigned long long GC9A01Emulator::NowNs() const {
+    return (SteadyNowNs() - this->startNs) + this->offsetNs;
+}
+
+void GC9A01Emulator::WaitUntilNs(unsigned long long timeNs) {
+    const unsigned long long now = this->NowNs();
+    if (timeNs > now) {
+        // Nothing to do but wait, so skip ahead instead of burning host time
+        this->offsetNs += timeNs - now;
+    }
+}
+
+void GC9A01Emulator::Sleep(unsigned long long durationNs) {
+    this->offsetNs += durationNs;
+}
+
+unsigned short GC9A01Emulator::GetScanLine(unsigned long long timeNs) const {
+    return ((timeNs % this->framePeriodNs) * SCAN_LINES) / this->framePeriodNs;
+}
+
+bool GC9A01Emulator::GetNextTearingEffectNs(unsigned long long afterNs, unsigned long long* edgeNs) const {
+    if (!this->tearingEffectOn) {
+        return false;
+    }
+    // Frames start at time 0, the edge comes tearLine lines into each of them
+    const unsigned long long offset = (this->tearLine * this->framePeriodNs) / SCAN_LINES;
+    if (afterNs < offset) {
+        *edgeNs = offset;
+    } else {
+        *edgeNs = offset + ((afterNs - offset) / this->framePeriodNs + 1U) * this->framePeriodNs;
+    }
+    return true;
+}
+
+void GC9A01Emulator::SetPin(unsigned char pin, bool value) {
+    if (pin == this->cs_pin) {
+        if ((ON == this->csLevel) && (OFF == value)) {
+            ++this->stats.csAssertions;
+        }
+        this->csLevel = value;
+    } else if (pin == this->dc_pin) {
+        if (this->dcLevel != value) {
+            ++this->stats.dcToggles;
+        }
+        this->dcLevel = value;
+    } else if (pin == this->rst_pin) {
+        if ((OFF == this->rstLevel) && (ON == value)) {
+            this->ResetRegisters();
+        }
+        this->rstLevel = value;
+    }
+}
+
+unsigned long long GC9A01Emulator::ScheduleTransfer(size_t dataSize) {
+    const unsigned long long now = this->NowNs();
+    const unsigned long long start = (this->busFreeAtNs > now) ? this->busFreeAtNs : now;
+    const unsigned long long wireTime = this->WireTimeNs(dataSize);
+    this->busFreeAtNs = start + wireTime;
+    this->stats.wireTimeNs += wireTime;
+    return this->busFreeAtNs;
+}
+
+void GC9A01Emulator::SpiWrite(const unsigned char data[], size_t dataSize) {
+    const unsigned long long doneAt = this->ScheduleTransfer(dataSize);
+    this->Receive(data, dataSize);
+    this->WaitUntilNs(doneAt);
+}
+
+void GC9A01Emulator::Receive(const unsigned char data[], size_t dataSize) {
+    if ((ON == this->csLevel) || (OFF == this->rstLevel)) {
+        // Not selected, the bytes are clocked to nobody
+        return;
+    }
+    for (size_t i = 0U; i < dataSize; ++i) {
+        this->Decode(data[i]);
+    }
+}
+
+void GC9A01Emulator::Decode(unsigned char byte) {
+    ++this->stats.bytes;
+
+    if (OFF == this->dcLevel) {
+        ++this->stats.commandBytes;
+        ++this->stats.commandCounts[byte];
+        this->command = byte;
+        this->parameterIndex = 0U;
+        this->pixelByteCount = 0U;
+        if (this->logEnabled) {
+            this->log.push_back({byte, {}});
+        }
+        switch (byte)
+        {
+        case 0x01U: // Software reset
+            this->ResetRegisters();
+            break;
+        case RegulativeCommandSet::MemoryWrite:
+            this->column = this->columnStart;
+            this->row = this->rowStart;
+            break;
+        case RegulativeCommandSet::TearingEffectLineOFF:
+            this->tearingEffectOn = false;
+            break;
+        case RegulativeCommandSet::TearingEffectLineON:
+            // TE rises at the line set by SetTearScanline, kept from before, the vertical blanking after a reset
+            this->tearingEffectOn = true;
+            break;
+        default:
+            break;
+        }
+        return;
+    }
+
+    ++this->stats.dataBytes;
+    if (this->logEnabled && !this->log.empty()) {
+        this->log.back().data.push_back(byte);
+    }
+
+    switch (this->command)
+    {
+    case RegulativeCommandSet::ColumnAddressSet:
+    case RegulativeCommandSet::RowAddressSet:
+    {
+        if (this->parameterIndex < 4U) {
+            this->parameters[this->parameterIndex] = byte;
+        }
+        ++this->parameterIndex;
+        if (4U == this->parameterIndex) {
+            const unsigned short start = (this->parameters[0] << 8U) | this->parameters[1];
+            const unsigned short end = (this->parameters[2] << 8U) | this->parameters[3];
+            if (RegulativeCommandSet::ColumnAddressSet == this->command) {
+                this->columnStart = start;
+                this->columnEnd = end;
+            } else {
+                this->rowStart = start;
+                this->rowEnd = end;
+            }
+        }
+        break;
+    }
+    case RegulativeCommandSet::MemoryWrite:
+    case RegulativeCommandSet::WriteMemoryContinue:
+        this->DecodePixelByte(byte);
+        break;
+    case RegulativeCommandSet::COLMODPixelFormatSet:
+        this->colmod = byte;
+        break;
+    case RegulativeCommandSet::SetTearScanline:
+        if (this->parameterIndex < 2U) {
+            this->parameters[this->parameterIndex] = byte;
+        }
+        ++this->parameterIndex;
+        if (2U == this->parameterIndex) {
+            // Only moves the line, TearingEffectLineON turns the output on
+            this->tearLine = (((this->parameters[0] & 0x01U) << 8U) | this->parameters[1]) % SCAN_LINES;
+        }
+        break;
+    case RegulativeCommandSet::MemoryAccessControl:
+        this->madctl = byte;
+        break;
+    default:
+        break;
+    }
+}
+
+void GC9A01Emulator::DecodePixelByte(unsigned char byte) {
+    this->pixelBytes[this->pixelByteCount] = byte;
+    ++this->pixelByteCount;
+
+    switch (this->colmod & 0x07U)
+    {
+    case COLMOD::DBI12BitPerPixel:
+    {
+        // R1G1 B1R2 G2B2, the first pixel is complete after the second byte
+        if (2U == this->pixelByteCount) {
+            const unsigned char r4 = this->pixelBytes[0] >> 4U;
+            const unsigned char g4 = this->pixelBytes[0] & 0x0FU;
+            const unsigned char b4 = this->pixelBytes[1] >> 4U;
+            this->StorePixel((r4 << 2U) | (r4 >> 2U), (g4 << 2U) | (g4 >> 2U), (b4 << 2U) | (b4 >> 2U));
+        } else if (3U == this->pixelByteCount) {
+            const unsigned char r4 = this->pixelBytes[1] & 0x0FU;
+            const unsigned char g4 = this->pixelBytes[2] >> 4U;
+            const unsigned char b4 = this->pixelBytes[2] & 0x0FU;
+            this->StorePixel((r4 << 2U) | (r4 >> 2U), (g4 << 2U) | (g4 >> 2U), (b4 << 2U) | (b4 >> 2U));
+            this->pixelByteCount = 0U;
+        }
+        break;
+    }
+    case COLMOD::DBI16BitPerPixel:
+    {
+        // RRRRRGGG GGGBBBBB
+        if (2U == this->pixelByteCount) {
+            const unsigned char r5 = this->pixelBytes[0] >> 3U;
+            const unsigned char g6 = ((this->pixelBytes[0] & 0x07U) << 3U) | (this->pixelBytes[1] >> 5U);
+            const unsigned char b5 = this->pixelBytes[1] & 0x1FU;
+            this->StorePixel((r5 << 1U) | (r5 >> 4U), g6, (b5 << 1U) | (b5 >> 4U));
+            this->pixelByteCount = 0U;
+        }
+        break;
+    }
+    default:
+    {
+        // 18 bits: RRRRRRxx GGGGGGxx BBBBBBxx
+        if (3U == this->pixelByteCount) {
+            this->StorePixel(this->pixelBytes[0] >> 2U, this->pixelBytes[1] >> 2U, this->pixelBytes[2] >> 2U);
+            this->pixelByteCount = 0U;
+        }
+        break;
+    }
+    }
+}
+
+void GC9A01Emulator::StorePixel(unsigned char r6, unsigned char g6, unsigned char b6) {
+    unsigned short x = this->column;
+    unsigned short y = this->row;
+
+    if (0U != (this->madctl & MemoryAccessControlOptions::MX)) {
+        x = (MAX_WIDTH - 1U) - x;
+    }
+    if (0U != (this->madctl & MemoryAccessControlOptions::MY)) {
+        y = (MAX_HEIGHT - 1U) - y;
+    }
+    if (0U != (this->madctl & MemoryAccessControlOptions::MV)) {
+        const unsigned short swap = x;
+        x = y;
+        y = swap;
+    }
+    if ((x < MAX_WIDTH) && (y < MAX_HEIGHT)) {
+        unsigned char* const pixel = &this->gram[(y * MAX_WIDTH + x) * RGB_COUNT];
+        const bool bgr = (0U != (this->madctl & MemoryAccessControlOptions::BGR));
+        pixel[0] = bgr ? b6 : r6;
+        pixel[1] = g6;
+        pixel[2] = bgr ? r6 : b6;
+    }
+    ++this->stats.pixelsWritten;
+
+    // The write pointer walks the window row by row and wraps to its start
+    if (this->column < this->columnEnd) {
+        ++this->column;
+    } else {
+        this->column = this->columnStart;
+        this->row = (this->row < this->rowEnd) ? (this->row + 1U) : this->rowStart;
+    }
+}
+
+void GC9A01Emulator::GetPixel(unsigned short x, unsigned short y, unsigned char* r, unsigned char* g, unsigned char* b) const {
+    const unsigned char* const pixel = &this->gram[(y * MAX_WIDTH + x) * RGB_COUNT];
+    *r = pixel[0];
+    *g = pixel[1];
+    *b = pixel[2];
+}
+
+#endif
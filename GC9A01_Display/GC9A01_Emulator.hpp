@@ -0,0 +1,132 @@
+#ifndef GC9A01_EMULATOR_HPP
+#define GC9A01_EMULATOR_HPP
+
+#ifdef GC9A01_HOST
+
+#include <vector>
+#include "GC9A01.hpp"
+
+typedef struct {
+    // Bytes clocked in while CS was asserted
+    unsigned long long bytes;
+    unsigned long long commandBytes;
+    unsigned long long dataBytes;
+    // High to low transitions of CS
+    unsigned long long csAssertions;
+    unsigned long long dcToggles;
+    unsigned long long pixelsWritten;
+    // Time the bus spent shifting bytes at the modeled SPI clock
+    unsigned long long wireTimeNs;
+    unsigned long long commandCounts[256];
+} GC9A01EmulatorStats;
+
+typedef struct {
+    unsigned char command;
+    std::vector<unsigned char> data;
+} GC9A01LoggedCommand;
+
+/* Host model of a GC9A01 panel sitting on the SPI bus.
+ *
+ * The byte stream is decoded the same way the controller does it: D/CX low selects a command, D/CX high
+ * bytes are its parameters. ColumnAddressSet, RowAddressSet, MemoryWrite, WriteMemoryContinue, COLMOD and MADCTL
+ * are interpreted and pixels land in a 240x240 GRAM with 6 bits per channel (the panel's native 262K colors),
+ * stored in physical panel orientation (MX/MY/MV and the BGR bit of MADCTL are applied).
+ *
+ * Time is modeled: CPU work runs in host time, every byte on the bus costs 8 clocks at the configured SPI
+ * clock and sleeps are skipped but accounted, so NowNs() behaves like the RP2040 timer would.
+ *
+ * The panel scan is a periodic timer on the same clock: every frame period (60 Hz by default) the scan runs through
+ * SCAN_LINES lines, gate (row) g being refreshed during line FIRST_GATE_LINE + g. TearingEffectLineON (35h) turns the
+ * TE output on and TearingEffectLineOFF (34h) off, SetTearScanline (44h) only sets the line STS it rises at, in
+ * either order and kept across 34h/35h. Until the first 44h after a reset it rises at the start of the vertical
+ * blanking. GetNextTearingEffectNs() gives the edges a TE pin interrupt would see.
+ * */
+class GC9A01Emulator
+{
+public:
+    // Lines per frame: back porch, the rows and front porch
+    static constexpr unsigned short SCAN_LINES = FIRST_GATE_LINE + MAX_HEIGHT + 8U;
+private:
+    unsigned char cs_pin;
+    unsigned char dc_pin;
+    unsigned char rst_pin;
+    bool csLevel;
+    bool dcLevel;
+    bool rstLevel;
+    unsigned int spiClockHz;
+
+    unsigned long long startNs;
+    unsigned long long offsetNs;
+    unsigned long long busFreeAtNs;
+
+    unsigned char command;
+    size_t parameterIndex;
+    unsigned char parameters[4U];
+    unsigned char colmod;
+    unsigned char madctl;
+    unsigned short columnStart;
+    unsigned short columnEnd;
+    unsigned short rowStart;
+    unsigned short rowEnd;
+    unsigned short column;
+    unsigned short row;
+    unsigned char pixelBytes[3U];
+    size_t pixelByteCount;
+    unsigned char gram[MAX_WIDTH * MAX_HEIGHT * RGB_COUNT];
+
+    GC9A01EmulatorStats stats;
+    bool logEnabled;
+    std::vector<GC9A01LoggedCommand> log;
+
+    unsigned long long framePeriodNs;
+    bool tearingEffectOn;
+    unsigned short tearLine;
+
+    void ResetRegisters();
+    void Decode(unsigned char byte);
+    void DecodePixelByte(unsigned char byte);
+    void StorePixel(unsigned char r6, unsigned char g6, unsigned char b6);
+    unsigned long long WireTimeNs(size_t dataSize) const;
+public:
+    GC9A01Emulator(unsigned char cs_pin, unsigned char rst_pin, unsigned char dc_pin);
+    ~GC9A01Emulator();
+
+    // HAL side
+    void SetPin(unsigned char pin, bool value);
+    void SpiWrite(const unsigned char data[], size_t dataSize);
+    unsigned long long ScheduleTransfer(size_t dataSize);
+    void Receive(const unsigned char data[], size_t dataSize);
+    void Sleep(unsigned long long durationNs);
+    unsigned long long NowNs() const;
+    void WaitUntilNs(unsigned long long timeNs);
+
+    inline void SetSpiClockHz(unsigned int clockHz) { this->spiClockHz = clockHz; }
+    inline unsigned int GetSpiClockHz() const { return this->spiClockHz; }
+
+    inline const GC9A01EmulatorStats& GetStats() const { return this->stats; }
+    void ResetStats();
+
+    // Record every command with its parameters (pixel data included), used to diff command streams
+    void SetLogEnabled(bool enabled);
+    inline const std::vector<GC9A01LoggedCommand>& GetLog() const { return this->log; }
+    inline void ClearLog() { this->log.clear(); }
+
+    inline void SetFramePeriodNs(unsigned long long periodNs) { this->framePeriodNs = periodNs; }
+    inline unsigned long long GetFramePeriodNs() const { return this->framePeriodNs; }
+    inline bool IsTearingEffectOn() const { return this->tearingEffectOn; }
+    // Scan line at which the TE output rises
+    inline unsigned short GetTearLine() const { return this->tearLine; }
+    // Line the panel scan is on at timeNs (see NowNs)
+    unsigned short GetScanLine(unsigned long long timeNs) const;
+    // First TE rising edge after afterNs, false while the TE output is off
+    bool GetNextTearingEffectNs(unsigned long long afterNs, unsigned long long* edgeNs) const;
+
+    // Channels are 6 bits wide, coordinates are physical
+    void GetPixel(unsigned short x, unsigned short y, unsigned char* r, unsigned char* g, unsigned char* b) const;
+    inline unsigned char GetCOLMOD() const { return this->colmod; }
+    inline unsigned char GetMemoryAccessControl() const { return this->madctl; }
+};
+
+#endif
+
+#endif
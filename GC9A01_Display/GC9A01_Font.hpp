@@ -0,0 +1,125 @@
+#ifndef GC9A01_FONT_HPP
+#define GC9A01_FONT_HPP
+
+#include <stddef.h>
+
+/* 5x7 pixel font for printable ASCII (' ' to '~'). Each glyph is 5 columns, left to right, with the top row in
+ * bit 0 of each column. Text advances one blank column past every glyph.
+ * */
+namespace GC9A01Font {
+    constexpr unsigned char WIDTH = 5U;
+    constexpr unsigned char HEIGHT = 7U;
+    constexpr unsigned char ADVANCE = WIDTH + 1U;
+    constexpr char FIRST = ' ';
+    constexpr char LAST = '~';
+
+    static constexpr unsigned char GLYPHS[LAST - FIRST + 1][WIDTH] = {
+        {0x00U, 0x00U, 0x00U, 0x00U, 0x00U}, // ' '
+        {0x00U, 0x00U, 0x5FU, 0x00U, 0x00U}, // '!'
+        {0x00U, 0x07U, 0x00U, 0x07U, 0x00U}, // '"'
+        {0x14U, 0x7FU, 0x14U, 0x7FU, 0x14U}, // '#'
+        {0x24U, 0x2AU, 0x7FU, 0x2AU, 0x12U}, // '$'
+        {0x23U, 0x13U, 0x08U, 0x64U, 0x62U}, // '%'
+        {0x36U, 0x49U, 0x56U, 0x20U, 0x50U}, // '&'
+        {0x00U, 0x05U, 0x03U, 0x00U, 0x00U}, // '''
+        {0x00U, 0x1CU, 0x22U, 0x41U, 0x00U}, // '('
+        {0x00U, 0x41U, 0x22U, 0x1CU, 0x00U}, // ')'
+        {0x08U, 0x2AU, 0x1CU, 0x2AU, 0x08U}, // '*'
+        {0x08U, 0x08U, 0x3EU, 0x08U, 0x08U}, // '+'
+        {0x00U, 0x50U, 0x30U, 0x00U, 0x00U}, // ','
+        {0x08U, 0x08U, 0x08U, 0x08U, 0x08U}, // '-'
+        {0x00U, 0x60U, 0x60U, 0x00U, 0x00U}, // '.'
+        {0x20U, 0x10U, 0x08U, 0x04U, 0x02U}, // '/'
+        {0x3EU, 0x51U, 0x49U, 0x45U, 0x3EU}, // '0'
+        {0x00U, 0x42U, 0x7FU, 0x40U, 0x00U}, // '1'
+        {0x42U, 0x61U, 0x51U, 0x49U, 0x46U}, // '2'
+        {0x21U, 0x41U, 0x45U, 0x4BU, 0x31U}, // '3'
+        {0x18U, 0x14U, 0x12U, 0x7FU, 0x10U}, // '4'
+        {0x27U, 0x45U, 0x45U, 0x45U, 0x39U}, // '5'
+        {0x3CU, 0x4AU, 0x49U, 0x49U, 0x30U}, // '6'
+        {0x01U, 0x71U, 0x09U, 0x05U, 0x03U}, // '7'
+        {0x36U, 0x49U, 0x49U, 0x49U, 0x36U}, // '8'
+        {0x06U, 0x49U, 0x49U, 0x29U, 0x1EU}, // '9'
+        {0x00U, 0x36U, 0x36U, 0x00U, 0x00U}, // ':'
+        {0x00U, 0x56U, 0x36U, 0x00U, 0x00U}, // ';'
+        {0x08U, 0x14U, 0x22U, 0x41U, 0x00U}, // '<'
+        {0x14U, 0x14U, 0x14U, 0x14U, 0x14U}, // '='
+        {0x00U, 0x41U, 0x22U, 0x14U, 0x08U}, // '>'
+        {0x02U, 0x01U, 0x51U, 0x09U, 0x06U}, // '?'
+        {0x32U, 0x49U, 0x79U, 0x41U, 0x3EU}, // '@'
+        {0x7EU, 0x11U, 0x11U, 0x11U, 0x7EU}, // 'A'
+        {0x7FU, 0x49U, 0x49U, 0x49U, 0x36U}, // 'B'
+        {0x3EU, 0x41U, 0x41U, 0x41U, 0x22U}, // 'C'
+        {0x7FU, 0x41U, 0x41U, 0x22U, 0x1CU}, // 'D'
+        {0x7FU, 0x49U, 0x49U, 0x49U, 0x41U}, // 'E'
+        {0x7FU, 0x09U, 0x09U, 0x01U, 0x01U}, // 'F'
+        {0x3EU, 0x41U, 0x41U, 0x51U, 0x32U}, // 'G'
+        {0x7FU, 0x08U, 0x08U, 0x08U, 0x7FU}, // 'H'
+        {0x00U, 0x41U, 0x7FU, 0x41U, 0x00U}, // 'I'
+        {0x20U, 0x40U, 0x41U, 0x3FU, 0x01U}, // 'J'
+        {0x7FU, 0x08U, 0x14U, 0x22U, 0x41U}, // 'K'
+        {0x7FU, 0x40U, 0x40U, 0x40U, 0x40U}, // 'L'
+        {0x7FU, 0x02U, 0x04U, 0x02U, 0x7FU}, // 'M'
+        {0x7FU, 0x04U, 0x08U, 0x10U, 0x7FU}, // 'N'
+        {0x3EU, 0x41U, 0x41U, 0x41U, 0x3EU}, // 'O'
+        {0x7FU, 0x09U, 0x09U, 0x09U, 0x06U}, // 'P'
+        {0x3EU, 0x41U, 0x51U, 0x21U, 0x5EU}, // 'Q'
+        {0x7FU, 0x09U, 0x19U, 0x29U, 0x46U}, // 'R'
+        {0x46U, 0x49U, 0x49U, 0x49U, 0x31U}, // 'S'
+        {0x01U, 0x01U, 0x7FU, 0x01U, 0x01U}, // 'T'
+        {0x3FU, 0x40U, 0x40U, 0x40U, 0x3FU}, // 'U'
+        {0x1FU, 0x20U, 0x40U, 0x20U, 0x1FU}, // 'V'
+        {0x7FU, 0x20U, 0x18U, 0x20U, 0x7FU}, // 'W'
+        {0x63U, 0x14U, 0x08U, 0x14U, 0x63U}, // 'X'
+        {0x03U, 0x04U, 0x78U, 0x04U, 0x03U}, // 'Y'
+        {0x61U, 0x51U, 0x49U, 0x45U, 0x43U}, // 'Z'
+        {0x00U, 0x7FU, 0x41U, 0x41U, 0x00U}, // '['
+        {0x02U, 0x04U, 0x08U, 0x10U, 0x20U}, // '\'
+        {0x00U, 0x41U, 0x41U, 0x7FU, 0x00U}, // ']'
+        {0x04U, 0x02U, 0x01U, 0x02U, 0x04U}, // '^'
+        {0x40U, 0x40U, 0x40U, 0x40U, 0x40U}, // '_'
+        {0x00U, 0x01U, 0x02U, 0x04U, 0x00U}, // '`'
+        {0x20U, 0x54U, 0x54U, 0x54U, 0x78U}, // 'a'
+        {0x7FU, 0x48U, 0x44U, 0x44U, 0x38U}, // 'b'
+        {0x38U, 0x44U, 0x44U, 0x44U, 0x20U}, // 'c'
+        {0x38U, 0x44U, 0x44U, 0x48U, 0x7FU}, // 'd'
+        {0x38U, 0x54U, 0x54U, 0x54U, 0x18U}, // 'e'
+        {0x08U, 0x7EU, 0x09U, 0x01U, 0x02U}, // 'f'
+        {0x0CU, 0x52U, 0x52U, 0x52U, 0x3EU}, // 'g'
+        {0x7FU, 0x08U, 0x04U, 0x04U, 0x78U}, // 'h'
+        {0x00U, 0x44U, 0x7DU, 0x40U, 0x00U}, // 'i'
+        {0x20U, 0x40U, 0x44U, 0x3DU, 0x00U}, // 'j'
+        {0x7FU, 0x10U, 0x28U, 0x44U, 0x00U}, // 'k'
+        {0x00U, 0x41U, 0x7FU, 0x40U, 0x00U}, // 'l'
+        {0x7CU, 0x04U, 0x18U, 0x04U, 0x78U}, // 'm'
+        {0x7CU, 0x08U, 0x04U, 0x04U, 0x78U}, // 'n'
+        {0x38U, 0x44U, 0x44U, 0x44U, 0x38U}, // 'o'
+        {0x7CU, 0x14U, 0x14U, 0x14U, 0x08U}, // 'p'
+        {0x08U, 0x14U, 0x14U, 0x18U, 0x7CU}, // 'q'
+        {0x7CU, 0x08U, 0x04U, 0x04U, 0x08U}, // 'r'
+        {0x48U, 0x54U, 0x54U, 0x54U, 0x20U}, // 's'
+        {0x04U, 0x3FU, 0x44U, 0x40U, 0x20U}, // 't'
+        {0x3CU, 0x40U, 0x40U, 0x20U, 0x7CU}, // 'u'
+        {0x1CU, 0x20U, 0x40U, 0x20U, 0x1CU}, // 'v'
+        {0x3CU, 0x40U, 0x30U, 0x40U, 0x3CU}, // 'w'
+        {0x44U, 0x28U, 0x10U, 0x28U, 0x44U}, // 'x'
+        {0x0CU, 0x50U, 0x50U, 0x50U, 0x3CU}, // 'y'
+        {0x44U, 0x64U, 0x54U, 0x4CU, 0x44U}, // 'z'
+        {0x00U, 0x08U, 0x36U, 0x41U, 0x00U}, // '{'
+        {0x00U, 0x00U, 0x7FU, 0x00U, 0x00U}, // '|'
+        {0x00U, 0x41U, 0x36U, 0x08U, 0x00U}, // '}'
+        {0x08U, 0x04U, 0x08U, 0x10U, 0x08U}, // '~'
+    };
+
+    // Columns of c, characters outside the font show as '?'
+    inline const unsigned char* GetGlyph(char c) {
+        return GLYPHS[((c < FIRST) || (c > LAST)) ? ('?' - FIRST) : (c - FIRST)];
+    }
+
+    // Width in pixels of count characters at scale, without the blank column after the last one
+    constexpr unsigned short GetTextWidth(size_t count, unsigned char scale) {
+        return (0U == count) ? 0U : static_cast<unsigned short>((count * ADVANCE - 1U) * scale);
+    }
+}
+
+#endif
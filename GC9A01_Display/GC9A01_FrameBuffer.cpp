@@ -0,0 +1,325 @@
+#include <string.h>
+#include "GC9A01_FrameBuffer.hpp"
+
+GC9A01FrameBuffer::GC9A01FrameBuffer(const GC9A01& display, unsigned short pixels[], unsigned short width, unsigned short height,
+                                     unsigned short originX, unsigned short originY)
+ : display(display), pixels(pixels), width(width), height(height), originX(originX), originY(originY), dirty(display),
+   lastFlushRects(0U), lastFlushBytes(0U), flushRow(nullptr), flushX(0U), flushWidth(0U) { }
+
+GC9A01DirtyRects::GC9A01DirtyRects(const GC9A01& display)
+ : display(display), count(0U) { }
+
+size_t GC9A01DirtyRects::Cost(const Rect& rect) const {
+    return GC9A01_DIRTY_RECT_OVERHEAD + this->display.GetImageBufferSize(rect.x1 - rect.x0 + 1U, rect.y1 - rect.y0 + 1U);
+}
+
+GC9A01DirtyRects::Rect GC9A01DirtyRects::Union(const Rect& a, const Rect& b) {
+    Rect rect;
+    rect.x0 = (a.x0 < b.x0) ? a.x0 : b.x0;
+    rect.y0 = (a.y0 < b.y0) ? a.y0 : b.y0;
+    rect.x1 = (a.x1 > b.x1) ? a.x1 : b.x1;
+    rect.y1 = (a.y1 > b.y1) ? a.y1 : b.y1;
+    return rect;
+}
+
+void GC9A01DirtyRects::Remove(size_t index) {
+    --this->count;
+    this->rects[index] = this->rects[this->count];
+}
+
+void GC9A01DirtyRects::Add(unsigned short x0, unsigned short y0, unsigned short w, unsigned short h, unsigned short width, unsigned short height) {
+    if ((x0 >= width) || (y0 >= height) || (0U == w) || (0U == h)) {
+        return;
+    }
+    Rect rect;
+    rect.x0 = x0;
+    rect.y0 = y0;
+    rect.x1 = ((width - x0) < w) ? (width - 1U) : (x0 + w - 1U);
+    rect.y1 = ((height - y0) < h) ? (height - 1U) : (y0 + h - 1U);
+
+    // Absorb every pending rectangle that is cheaper to send as part of the bounding box, the box grows
+    // with each merge so the scan starts over
+    size_t index = 0U;
+    while (index < this->count) {
+        const Rect merged = Union(rect, this->rects[index]);
+        if (this->Cost(merged) <= (this->Cost(rect) + this->Cost(this->rects[index]))) {
+            rect = merged;
+            this->Remove(index);
+            index = 0U;
+        } else {
+            ++index;
+        }
+    }
+
+    if (GC9A01_MAX_DIRTY_RECTS == this->count) {
+        // No room left, merge with the rectangle that adds the least
+        size_t best = 0U;
+        size_t bestExtra = static_cast<size_t>(-1);
+        for (index = 0U; index < this->count; ++index) {
+            const size_t extra = this->Cost(Union(rect, this->rects[index])) - this->Cost(this->rects[index]);
+            if (extra < bestExtra) {
+                bestExtra = extra;
+                best = index;
+            }
+        }
+        rect = Union(rect, this->rects[best]);
+        this->Remove(best);
+    }
+    this->rects[this->count] = rect;
+    ++this->count;
+}
+
+void GC9A01DirtyRects::Sort() {
+    for (size_t index = 1U; index < this->count; ++index) {
+        const Rect rect = this->rects[index];
+        size_t slot = index;
+        while ((0U < slot) && (this->rects[slot - 1U].y0 > rect.y0)) {
+            this->rects[slot] = this->rects[slot - 1U];
+            --slot;
+        }
+        this->rects[slot] = rect;
+    }
+}
+
+void GC9A01FrameBuffer::MarkDirty(unsigned short x0, unsigned short y0, unsigned short w, unsigned short h) {
+    this->dirty.Add(x0, y0, w, h, this->width, this->height);
+}
+
+void GC9A01FrameBuffer::Clear(unsigned char r, unsigned char g, unsigned char b) {
+    this->FillRect(0U, 0U, this->width, this->height, r, g, b);
+}
+
+void GC9A01FrameBuffer::SetPixel(unsigned short x, unsigned short y, unsigned char r, unsigned char g, unsigned char b) {
+    if ((x < this->width) && (y < this->height)) {
+        this->pixels[y * this->width + x] = Color(r, g, b);
+        this->MarkDirty(x, y, 1U, 1U);
+    }
+}
+
+void GC9A01FrameBuffer::FillRect(unsigned short x0, unsigned short y0, unsigned short w, unsigned short h, unsigned char r, unsigned char g, unsigned char b) {
+    if ((x0 >= this->width) || (y0 >= this->height)) {
+        return;
+    }
+    const unsigned short color = Color(r, g, b);
+    const unsigned short x1 = ((this->width - x0) < w) ? this->width : (x0 + w);
+    const unsigned short y1 = ((this->height - y0) < h) ? this->height : (y0 + h);
+
+    for (unsigned short y = y0; y < y1; ++y) {
+        unsigned short* const row = &this->pixels[y * this->width];
+        for (unsigned short x = x0; x < x1; ++x) {
+            row[x] = color;
+        }
+    }
+    this->MarkDirty(x0, y0, w, h);
+}
+
+void GC9A01FrameBuffer::DrawImage(const unsigned char image[], unsigned short x0, unsigned short y0, unsigned short w, unsigned short h) {
+    if ((x0 >= this->width) || (y0 >= this->height)) {
+        return;
+    }
+    const unsigned short x1 = ((this->width - x0) < w) ? this->width : (x0 + w);
+    const unsigned short y1 = ((this->height - y0) < h) ? this->height : (y0 + h);
+
+    for (unsigned short y = y0; y < y1; ++y) {
+        const unsigned char* source = &image[(y - y0) * w * RGB_COUNT];
+        unsigned short* const row = &this->pixels[y * this->width];
+        for (unsigned short x = x0; x < x1; ++x) {
+            row[x] = Color(source[0], source[1], source[2]);
+            source += RGB_COUNT;
+        }
+    }
+    this->MarkDirty(x0, y0, w, h);
+}
+
+void GC9A01FrameBuffer::ReadPixels(void* context, size_t pixelCount, unsigned char rgb[]) {
+    GC9A01FrameBuffer* const frameBuffer = static_cast<GC9A01FrameBuffer*>(context);
+    const unsigned short* row = frameBuffer->flushRow;
+    unsigned short x = frameBuffer->flushX;
+
+    for (size_t i = 0U; i < pixelCount; ++i) {
+        // Expand to 8 bits per channel by repeating the high bits, the 16 bit kernel gives the same value back
+        const unsigned int color = row[x];
+        const unsigned int r5 = color >> 11U;
+        const unsigned int g6 = (color >> 5U) & 0x3FU;
+        const unsigned int b5 = color & 0x1FU;
+        rgb[0] = (r5 << 3U) | (r5 >> 2U);
+        rgb[1] = (g6 << 2U) | (g6 >> 4U);
+        rgb[2] = (b5 << 3U) | (b5 >> 2U);
+        rgb += RGB_COUNT;
+
+        ++x;
+        if (frameBuffer->flushWidth == x) {
+            row += frameBuffer->width;
+            x = 0U;
+        }
+    }
+    frameBuffer->flushRow = row;
+    frameBuffer->flushX = x;
+}
+
+void GC9A01FrameBuffer::Flush() {
+    this->lastFlushRects = this->dirty.GetCount();
+    this->lastFlushBytes = 0U;
+
+    this->dirty.Sort();
+    for (size_t index = 0U; index < this->dirty.GetCount(); ++index) {
+        const Rect& rect = this->dirty.Get(index);
+        const unsigned short w = rect.x1 - rect.x0 + 1U;
+        const unsigned short h = rect.y1 - rect.y0 + 1U;
+
+        this->flushRow = &this->pixels[rect.y0 * this->width + rect.x0];
+        this->flushX = 0U;
+        this->flushWidth = w;
+        this->display.WritePixels(this->originX + rect.x0, this->originY + rect.y0, w, h, &GC9A01FrameBuffer::ReadPixels, this);
+        this->lastFlushBytes += this->display.GetImageBufferSize(w, h);
+    }
+    this->dirty.Clear();
+}
+
+GC9A01IndexedFrameBuffer::GC9A01IndexedFrameBuffer(const GC9A01& display, unsigned char pixels[], unsigned char bpp, unsigned short width,
+                                                   unsigned short height, unsigned short originX, unsigned short originY)
+ : display(display), pixels(pixels), width(width), height(height), originX(originX), originY(originY), bpp(bpp),
+   stride(GetBufferSize(width, 1U, bpp)), dirty(display), palette{0U}, lut{0U}, lutValid(false), lutFormat(PF16BitsPerPixel), lutVersion(0U),
+   lastFlushRects(0U), lastFlushBytes(0U), flushY(0U), flushX(0U), flushX0(0U), flushX1(0U) { }
+
+void GC9A01IndexedFrameBuffer::SetPaletteColor(unsigned char index, unsigned char r, unsigned char g, unsigned char b) {
+    this->palette[index * RGB_COUNT] = r;
+    this->palette[index * RGB_COUNT + 1U] = g;
+    this->palette[index * RGB_COUNT + 2U] = b;
+    this->lutValid = false;
+}
+
+void GC9A01IndexedFrameBuffer::SetPalette(const unsigned char rgb[], size_t count) {
+    memcpy(this->palette, rgb, ((count < 256U) ? count : 256U) * RGB_COUNT);
+    this->lutValid = false;
+}
+
+void GC9A01IndexedFrameBuffer::BuildLut() {
+    // One pixel at a time: 2 or 3 bytes, at 12 bits the odd pixel form RRRRGGGG BBBB0000 is the 12 bit code
+    const size_t entries = 1U << this->bpp;
+    for (size_t index = 0U; index < entries; ++index) {
+        this->display.ConvertPixels(&this->palette[index * RGB_COUNT], 1U, &this->lut[index * RGB_COUNT]);
+    }
+    this->lutFormat = this->display.GetPixelFormat();
+    this->lutVersion = this->display.GetConversionVersion();
+    this->lutValid = true;
+}
+
+unsigned char GC9A01IndexedFrameBuffer::GetPixel(unsigned short x, unsigned short y) const {
+    return ((x < this->width) && (y < this->height)) ? this->GetIndex(x, y) : 0U;
+}
+
+void GC9A01IndexedFrameBuffer::SetPixel(unsigned short x, unsigned short y, unsigned char index) {
+    if ((x < this->width) && (y < this->height)) {
+        this->PutIndex(x, y, index);
+        this->MarkDirty(x, y, 1U, 1U);
+    }
+}
+
+void GC9A01IndexedFrameBuffer::Clear(unsigned char index) {
+    this->FillRect(0U, 0U, this->width, this->height, index);
+}
+
+void GC9A01IndexedFrameBuffer::FillRect(unsigned short x0, unsigned short y0, unsigned short w, unsigned short h, unsigned char index) {
+    if ((x0 >= this->width) || (y0 >= this->height)) {
+        return;
+    }
+    const unsigned short x1 = ((this->width - x0) < w) ? this->width : (x0 + w);
+    const unsigned short y1 = ((this->height - y0) < h) ? this->height : (y0 + h);
+    const unsigned short pixelsPerByte = 8U / this->bpp;
+
+    // The index repeated over a whole byte
+    unsigned char pattern = index & ((1U << this->bpp) - 1U);
+    for (unsigned int shift = this->bpp; shift < 8U; shift *= 2U) {
+        pattern |= pattern << shift;
+    }
+
+    for (unsigned short y = y0; y < y1; ++y) {
+        unsigned short x = x0;
+        // Partial bytes at both ends, whole bytes in between
+        for (; (x < x1) && (0U != (x % pixelsPerByte)); ++x) {
+            this->PutIndex(x, y, index);
+        }
+        const unsigned short wholeBytes = (x1 - x) / pixelsPerByte;
+        memset(&this->pixels[y * this->stride + (x / pixelsPerByte)], pattern, wholeBytes);
+        x += wholeBytes * pixelsPerByte;
+        for (; x < x1; ++x) {
+            this->PutIndex(x, y, index);
+        }
+    }
+    this->MarkDirty(x0, y0, w, h);
+}
+
+void GC9A01IndexedFrameBuffer::MarkDirty(unsigned short x0, unsigned short y0, unsigned short w, unsigned short h) {
+    this->dirty.Add(x0, y0, w, h, this->width, this->height);
+}
+
+size_t GC9A01IndexedFrameBuffer::ReadPixels(void* context, size_t pixelCount, unsigned char out[]) {
+    GC9A01IndexedFrameBuffer* const frameBuffer = static_cast<GC9A01IndexedFrameBuffer*>(context);
+    const unsigned char* const lut = frameBuffer->lut;
+    unsigned char* o = out;
+
+    switch (frameBuffer->lutFormat)
+    {
+    case PF12BitsPerPixel:
+    {
+        size_t i = 0U;
+        for (; (i + 2U) <= pixelCount; i += 2U) {
+            const unsigned char* const a = &lut[frameBuffer->NextIndex() * RGB_COUNT];
+            const unsigned char* const b = &lut[frameBuffer->NextIndex() * RGB_COUNT];
+            o[0] = a[0];
+            o[1] = a[1] | (b[0] >> 4U);
+            o[2] = (b[0] << 4U) | (b[1] >> 4U);
+            o += 3U;
+        }
+        if (i < pixelCount) {
+            const unsigned char* const a = &lut[frameBuffer->NextIndex() * RGB_COUNT];
+            o[0] = a[0];
+            o[1] = a[1];
+            o += 2U;
+        }
+        break;
+    }
+    case PF16BitsPerPixel:
+        for (size_t i = 0U; i < pixelCount; ++i) {
+            const unsigned char* const entry = &lut[frameBuffer->NextIndex() * RGB_COUNT];
+            o[0] = entry[0];
+            o[1] = entry[1];
+            o += 2U;
+        }
+        break;
+    default:
+        for (size_t i = 0U; i < pixelCount; ++i) {
+            const unsigned char* const entry = &lut[frameBuffer->NextIndex() * RGB_COUNT];
+            o[0] = entry[0];
+            o[1] = entry[1];
+            o[2] = entry[2];
+            o += 3U;
+        }
+        break;
+    }
+    return o - out;
+}
+
+void GC9A01IndexedFrameBuffer::Flush() {
+    if (!this->lutValid || (this->lutVersion != this->display.GetConversionVersion())) {
+        this->BuildLut();
+    }
+    this->lastFlushRects = this->dirty.GetCount();
+    this->lastFlushBytes = 0U;
+
+    this->dirty.Sort();
+    for (size_t index = 0U; index < this->dirty.GetCount(); ++index) {
+        const Rect& rect = this->dirty.Get(index);
+        const unsigned short w = rect.x1 - rect.x0 + 1U;
+        const unsigned short h = rect.y1 - rect.y0 + 1U;
+
+        this->flushX0 = rect.x0;
+        this->flushX1 = rect.x1;
+        this->flushX = rect.x0;
+        this->flushY = rect.y0;
+        this->display.WriteNativePixels(this->originX + rect.x0, this->originY + rect.y0, w, h, &GC9A01IndexedFrameBuffer::ReadPixels, this);
+        this->lastFlushBytes += this->display.GetImageBufferSize(w, h);
+    }
+    this->dirty.Clear();
+}
@@ -0,0 +1,193 @@
+#ifndef GC9A01_FRAME_BUFFER_HPP
+#define GC9A01_FRAME_BUFFER_HPP
+
+#include "GC9A01.hpp"
+
+// Dirty rectangles tracked before the cheapest pair is merged regardless of cost
+#ifndef GC9A01_MAX_DIRTY_RECTS
+#define GC9A01_MAX_DIRTY_RECTS 8U
+#endif
+
+/* Fixed cost of sending one rectangle, in wire bytes: ColumnAddressSet, RowAddressSet and MemoryWrite (11 bytes)
+ * plus the CPU time of framing the write and starting DMA, which is worth about as much again at 40 MHz.
+ * Two dirty rectangles are merged when their bounding box costs no more than sending both. */
+#ifndef GC9A01_DIRTY_RECT_OVERHEAD
+#define GC9A01_DIRTY_RECT_OVERHEAD 32U
+#endif
+
+/* Pending damage of a framebuffer, as a short list of rectangles.
+ *
+ * A new rectangle absorbs every pending one whose bounding box costs no more than sending both (payload in the
+ * panel format plus GC9A01_DIRTY_RECT_OVERHEAD). When the list is full the cheapest merge is made regardless.
+ * */
+class GC9A01DirtyRects
+{
+public:
+    // Inclusive corners, in framebuffer coordinates
+    typedef struct {
+        unsigned short x0;
+        unsigned short y0;
+        unsigned short x1;
+        unsigned short y1;
+    } Rect;
+private:
+    const GC9A01& display;
+    Rect rects[GC9A01_MAX_DIRTY_RECTS];
+    size_t count;
+    size_t Cost(const Rect& rect) const;
+    static Rect Union(const Rect& a, const Rect& b);
+    void Remove(size_t index);
+public:
+    GC9A01DirtyRects(const GC9A01& display);
+    // Adds x0, y0, w, h clipped to width x height
+    void Add(unsigned short x0, unsigned short y0, unsigned short w, unsigned short h, unsigned short width, unsigned short height);
+    // Orders the rectangles top to bottom, a rectangle right below the previous one with the same columns is then a WriteMemoryContinue
+    void Sort();
+    inline void Clear() { this->count = 0U; }
+    inline size_t GetCount() const { return this->count; }
+    inline const Rect& Get(size_t index) const { return this->rects[index]; }
+};
+
+/* RGB565 framebuffer in application RAM, mirrored to a width x height area of the panel at (originX, originY).
+ *
+ * Drawing calls only touch RAM and record the area they changed (see GC9A01DirtyRects). Flush() sends just those
+ * areas, each rectangle is converted to the panel format on the fly (see GC9A01::WritePixels).
+ *
+ * The pixel storage belongs to the caller, width * height unsigned shorts (115 KB for the full screen).
+ * */
+class GC9A01FrameBuffer
+{
+public:
+    typedef GC9A01DirtyRects::Rect Rect;
+private:
+    const GC9A01& display;
+    unsigned short* pixels;
+    unsigned short width;
+    unsigned short height;
+    unsigned short originX;
+    unsigned short originY;
+    GC9A01DirtyRects dirty;
+    size_t lastFlushRects;
+    size_t lastFlushBytes;
+    // Read position of the rectangle being flushed
+    const unsigned short* flushRow;
+    unsigned short flushX;
+    unsigned short flushWidth;
+    static void ReadPixels(void* context, size_t pixelCount, unsigned char rgb[]);
+public:
+    GC9A01FrameBuffer(const GC9A01& display, unsigned short pixels[], unsigned short width = MAX_WIDTH, unsigned short height = MAX_HEIGHT,
+                      unsigned short originX = 0U, unsigned short originY = 0U);
+    static inline unsigned short Color(unsigned char r, unsigned char g, unsigned char b) {
+        return ((r & 0xF8U) << 8U) | ((g & 0xFCU) << 3U) | (b >> 3U);
+    }
+    inline unsigned short GetWidth() const { return this->width; }
+    inline unsigned short GetHeight() const { return this->height; }
+    // Direct access to the pixels, call MarkDirty for what is changed through it
+    inline unsigned short* GetPixels() { return this->pixels; }
+    void Clear(unsigned char r, unsigned char g, unsigned char b);
+    void SetPixel(unsigned short x, unsigned short y, unsigned char r, unsigned char g, unsigned char b);
+    void FillRect(unsigned short x0, unsigned short y0, unsigned short w, unsigned short h, unsigned char r, unsigned char g, unsigned char b);
+    // RGB888 image, clipped to the framebuffer
+    void DrawImage(const unsigned char image[], unsigned short x0, unsigned short y0, unsigned short w, unsigned short h);
+    // Records a changed area, clipped to the framebuffer and merged with the pending ones
+    void MarkDirty(unsigned short x0, unsigned short y0, unsigned short w, unsigned short h);
+    // Sends the dirty areas to the panel and forgets them
+    void Flush();
+    inline size_t GetDirtyCount() const { return this->dirty.GetCount(); }
+    inline const Rect& GetDirtyRect(size_t index) const { return this->dirty.Get(index); }
+    // Rectangles and pixel payload bytes (in the current panel format) sent by the last Flush()
+    inline size_t GetLastFlushRects() const { return this->lastFlushRects; }
+    inline size_t GetLastFlushBytes() const { return this->lastFlushBytes; }
+};
+
+/* Palettized framebuffer: 1, 2, 4 or 8 bits per pixel hold an index into a palette of up to 256 RGB888 colors.
+ *
+ * Drawing works on indices. At Flush() the indices are expanded through a lookup table that holds every palette
+ * entry already in the panel format (rebuilt when the palette or the panel conversion changes), so the dirty
+ * areas go out through GC9A01::WriteNativePixels without any per pixel conversion.
+ *
+ * Rows are packed MSB first (the leftmost pixel in the high bits) and padded to a whole byte. A full screen takes
+ * GetBufferSize(MAX_WIDTH, MAX_HEIGHT, bpp): 7.2 KB at 1 bpp up to 57.6 KB at 8 bpp, against 115 KB in RGB565.
+ * */
+class GC9A01IndexedFrameBuffer
+{
+public:
+    typedef GC9A01DirtyRects::Rect Rect;
+private:
+    const GC9A01& display;
+    unsigned char* pixels;
+    unsigned short width;
+    unsigned short height;
+    unsigned short originX;
+    unsigned short originY;
+    unsigned char bpp;
+    size_t stride;
+    GC9A01DirtyRects dirty;
+    unsigned char palette[256U * RGB_COUNT];
+    // Palette in the panel format, 3 bytes per entry (12 bits: the 12 bit code in the first two)
+    unsigned char lut[256U * RGB_COUNT];
+    bool lutValid;
+    PixelFormat lutFormat;
+    // GC9A01::GetConversionVersion the table was built at
+    unsigned int lutVersion;
+    size_t lastFlushRects;
+    size_t lastFlushBytes;
+    // Read position of the rectangle being flushed
+    unsigned short flushY;
+    unsigned short flushX;
+    unsigned short flushX0;
+    unsigned short flushX1;
+    inline unsigned char GetIndex(unsigned short x, unsigned short y) const {
+        const unsigned int bit = x * this->bpp;
+        const unsigned int shift = 8U - this->bpp - (bit & 7U);
+        return (this->pixels[y * this->stride + (bit >> 3U)] >> shift) & ((1U << this->bpp) - 1U);
+    }
+    inline void PutIndex(unsigned short x, unsigned short y, unsigned char index) {
+        const unsigned int bit = x * this->bpp;
+        const unsigned int shift = 8U - this->bpp - (bit & 7U);
+        const unsigned char mask = ((1U << this->bpp) - 1U) << shift;
+        unsigned char* const byte = &this->pixels[y * this->stride + (bit >> 3U)];
+        *byte = (*byte & ~mask) | ((index << shift) & mask);
+    }
+    // Index at the flush position, which then moves on through the rectangle row by row
+    inline unsigned char NextIndex() {
+        const unsigned char index = this->GetIndex(this->flushX, this->flushY);
+        ++this->flushX;
+        if (this->flushX > this->flushX1) {
+            this->flushX = this->flushX0;
+            ++this->flushY;
+        }
+        return index;
+    }
+    void BuildLut();
+    static size_t ReadPixels(void* context, size_t pixelCount, unsigned char out[]);
+public:
+    // Bytes of storage a width x height framebuffer takes at bpp bits per pixel
+    static constexpr size_t GetBufferSize(unsigned short width, unsigned short height, unsigned char bpp) {
+        return ((width * bpp + 7U) / 8U) * height;
+    }
+    /* @param bpp 1, 2, 4 or 8
+     * @param pixels GetBufferSize(width, height, bpp) bytes
+     * */
+    GC9A01IndexedFrameBuffer(const GC9A01& display, unsigned char pixels[], unsigned char bpp, unsigned short width = MAX_WIDTH,
+                             unsigned short height = MAX_HEIGHT, unsigned short originX = 0U, unsigned short originY = 0U);
+    inline unsigned short GetWidth() const { return this->width; }
+    inline unsigned short GetHeight() const { return this->height; }
+    inline unsigned char GetBitsPerPixel() const { return this->bpp; }
+    // Direct access to the packed indices, call MarkDirty for what is changed through it
+    inline unsigned char* GetPixels() { return this->pixels; }
+    void SetPaletteColor(unsigned char index, unsigned char r, unsigned char g, unsigned char b);
+    // count RGB888 colors from index 0
+    void SetPalette(const unsigned char rgb[], size_t count);
+    void Clear(unsigned char index);
+    void SetPixel(unsigned short x, unsigned short y, unsigned char index);
+    unsigned char GetPixel(unsigned short x, unsigned short y) const;
+    void FillRect(unsigned short x0, unsigned short y0, unsigned short w, unsigned short h, unsigned char index);
+    void MarkDirty(unsigned short x0, unsigned short y0, unsigned short w, unsigned short h);
+    void Flush();
+    inline size_t GetDirtyCount() const { return this->dirty.GetCount(); }
+    inline size_t GetLastFlushRects() const { return this->lastFlushRects; }
+    inline size_t GetLastFlushBytes() const { return this->lastFlushBytes; }
+};
+
+#endif
@@ -0,0 +1,227 @@
+#include <string.h>
+#include "GC9A01_FrameScheduler.hpp"
+
+// Wait for the first TE edges before the frame period is known, i.e. a panel running at 10 Hz or more
+static constexpr unsigned long long UNKNOWN_PERIOD_TIMEOUT_US = 100000U;
+
+#ifdef GC9A01_HOST
+
+#include "GC9A01_Emulator.hpp"
+
+GC9A01FrameScheduler::GC9A01FrameScheduler(const GC9A01& display, unsigned char te_pin, unsigned char pulseWidth)
+ : display(display), te_pin(te_pin), pulseWidth(pulseWidth), running(false), firstRow(0U), edgeCount(0U), lastEdgeUs(0U), periodUs(0U),
+   periodValid(false), frameStartUs(0U), deadlineUs(0U), framePaced(false), hostServicedNs(0U) {
+    this->ResetStats();
+}
+
+GC9A01FrameScheduler::~GC9A01FrameScheduler() {
+    if (this->running) {
+        this->Stop();
+    }
+}
+
+void GC9A01FrameScheduler::Start() {
+    GC9A01HAL::PinFunctionSio(this->te_pin);
+    GC9A01HAL::PinInput(this->te_pin);
+    this->display.SetTearingEffectControl(false, this->pulseWidth);
+    this->display.TearingEffectOn(false);
+    this->display.SetTearLine(FIRST_GATE_LINE + this->firstRow + 1U);
+    this->periodValid = false;
+    // Edges from before the interrupt was enabled are not seen
+    this->hostServicedNs = GC9A01HAL::TimeNs();
+    this->running = true;
+}
+
+void GC9A01FrameScheduler::Stop() {
+    this->running = false;
+    this->display.TearingEffectOff();
+}
+
+void GC9A01FrameScheduler::HostService() {
+    GC9A01Emulator* const emulator = GC9A01HAL::GetEmulator();
+    const unsigned long long now = GC9A01HAL::TimeNs();
+    unsigned long long edge = 0U;
+    while (this->running && (nullptr != emulator) && emulator->GetNextTearingEffectNs(this->hostServicedNs, &edge) && (edge <= now)) {
+        this->hostServicedNs = edge;
+        this->OnTearingEffect(edge / 1000U);
+    }
+    if ((nullptr == emulator) || !emulator->IsTearingEffectOn()) {
+        this->hostServicedNs = now;
+    }
+}
+
+void GC9A01FrameScheduler::ReadEdgeTimes(unsigned long long* lastEdge, unsigned long long* period) const {
+    // The edges are delivered by HostService, on the same thread
+    *lastEdge = this->lastEdgeUs;
+    *period = this->periodUs;
+}
+
+bool GC9A01FrameScheduler::WaitForEdge(unsigned long long timeoutUs) {
+    // Edges that passed while nobody polled are history, as they would be for the IRQ
+    this->HostService();
+    const unsigned long seen = this->edgeCount;
+    const unsigned long long timeoutNs = GC9A01HAL::TimeNs() + timeoutUs * 1000U;
+    while (seen == this->edgeCount) {
+        GC9A01Emulator* const emulator = GC9A01HAL::GetEmulator();
+        unsigned long long edge = 0U;
+        if ((nullptr == emulator) || !emulator->GetNextTearingEffectNs(this->hostServicedNs, &edge) || (edge > timeoutNs)) {
+            GC9A01HAL::WaitUntilNs(timeoutNs);
+            this->HostService();
+            return seen != this->edgeCount;
+        }
+        GC9A01HAL::WaitUntilNs(edge);
+        this->HostService();
+    }
+    return true;
+}
+
+#else
+
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+static GC9A01FrameScheduler* pinOwners[NUM_BANK0_GPIOS] = { nullptr };
+static bool irqHandlerInstalled = false;
+
+GC9A01FrameScheduler::GC9A01FrameScheduler(const GC9A01& display, unsigned char te_pin, unsigned char pulseWidth)
+ : display(display), te_pin(te_pin), pulseWidth(pulseWidth), running(false), firstRow(0U), edgeCount(0U), lastEdgeUs(0U), periodUs(0U),
+   periodValid(false), frameStartUs(0U), deadlineUs(0U), framePaced(false) {
+    this->ResetStats();
+}
+
+GC9A01FrameScheduler::~GC9A01FrameScheduler() {
+    if (this->running) {
+        this->Stop();
+    }
+}
+
+void GC9A01FrameScheduler::Start() {
+    GC9A01HAL::PinFunctionSio(this->te_pin);
+    GC9A01HAL::PinInput(this->te_pin);
+    this->display.SetTearingEffectControl(false, this->pulseWidth);
+    this->display.TearingEffectOn(false);
+    this->display.SetTearLine(FIRST_GATE_LINE + this->firstRow + 1U);
+    this->periodValid = false;
+
+    pinOwners[this->te_pin] = this;
+    this->running = true;
+    if (!irqHandlerInstalled) {
+        // One shared handler serves every scheduler, the single gpio_set_irq_callback() callback stays with the application
+        irq_add_shared_handler(IO_IRQ_BANK0, &GC9A01FrameScheduler::IrqHandler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irqHandlerInstalled = true;
+    }
+    gpio_acknowledge_irq(this->te_pin, GPIO_IRQ_EDGE_RISE);
+    gpio_set_irq_enabled(this->te_pin, GPIO_IRQ_EDGE_RISE, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+}
+
+void GC9A01FrameScheduler::Stop() {
+    gpio_set_irq_enabled(this->te_pin, GPIO_IRQ_EDGE_RISE, false);
+    pinOwners[this->te_pin] = nullptr;
+    this->running = false;
+    this->display.TearingEffectOff();
+}
+
+void GC9A01FrameScheduler::IrqHandler() {
+    const unsigned long long now = time_us_64();
+    for (unsigned int pin = 0U; pin < NUM_BANK0_GPIOS; ++pin) {
+        GC9A01FrameScheduler* const owner = pinOwners[pin];
+        if ((nullptr != owner) && (0U != (gpio_get_irq_event_mask(pin) & GPIO_IRQ_EDGE_RISE))) {
+            gpio_acknowledge_irq(pin, GPIO_IRQ_EDGE_RISE);
+            owner->OnTearingEffect(now);
+        }
+    }
+}
+
+void GC9A01FrameScheduler::ReadEdgeTimes(unsigned long long* lastEdge, unsigned long long* period) const {
+    const uint32_t interrupts = save_and_disable_interrupts();
+    *lastEdge = this->lastEdgeUs;
+    *period = this->periodUs;
+    restore_interrupts(interrupts);
+}
+
+bool GC9A01FrameScheduler::WaitForEdge(unsigned long long timeoutUs) {
+    const unsigned long seen = this->edgeCount;
+    const unsigned long long timeout = time_us_64() + timeoutUs;
+    while (seen == this->edgeCount) {
+        if (time_us_64() >= timeout) {
+            return false;
+        }
+        tight_loop_contents();
+    }
+    return true;
+}
+
+#endif
+
+void GC9A01FrameScheduler::OnTearingEffect(unsigned long long timeUs) {
+    if (this->periodValid) {
+        const unsigned long long period = timeUs - this->lastEdgeUs;
+        // Averaged over about 8 frames against IRQ latency
+        this->periodUs = (0U == this->periodUs) ? period : ((this->periodUs * 7U + period + 4U) / 8U);
+    }
+    this->lastEdgeUs = timeUs;
+    this->periodValid = true;
+    ++this->edgeCount;
+}
+
+void GC9A01FrameScheduler::SetFirstRow(unsigned short row) {
+    if (row == this->firstRow) {
+        return;
+    }
+    this->firstRow = row;
+    if (this->running) {
+        this->display.SetTearLine(FIRST_GATE_LINE + row + 1U);
+        // The next edge comes after a partial frame
+        this->periodValid = false;
+    }
+}
+
+unsigned long long GC9A01FrameScheduler::GetFramePeriodUs() const {
+    unsigned long long lastEdge = 0U;
+    unsigned long long period = 0U;
+    this->ReadEdgeTimes(&lastEdge, &period);
+    return period;
+}
+
+bool GC9A01FrameScheduler::BeginFrame() {
+    unsigned long long lastEdge = 0U;
+    unsigned long long period = 0U;
+    this->ReadEdgeTimes(&lastEdge, &period);
+    const unsigned long long timeoutUs = (0U == period) ? UNKNOWN_PERIOD_TIMEOUT_US : (period * 2U);
+    this->framePaced = this->running && this->WaitForEdge(timeoutUs);
+    if (!this->framePaced) {
+        ++this->stats.timeouts;
+        return false;
+    }
+    // Until the period is measured, assume the panel default of 60 Hz
+    this->ReadEdgeTimes(&lastEdge, &period);
+    this->frameStartUs = lastEdge;
+    this->deadlineUs = this->frameStartUs + ((0U == period) ? (1000000U / 60U) : period);
+    return true;
+}
+
+void GC9A01FrameScheduler::EndFrame() {
+    this->display.WaitIdle();
+    const unsigned long long end = GC9A01HAL::TimeUs();
+    this->display.MarkFrame();
+    if (!this->framePaced) {
+        return;
+    }
+    this->framePaced = false;
+
+    const long long slack = static_cast<long long>(this->deadlineUs) - static_cast<long long>(end);
+    this->stats.lastDurationUs = end - this->frameStartUs;
+    if ((0U == this->stats.frames) || (slack < this->stats.worstSlackUs)) {
+        this->stats.worstSlackUs = slack;
+    }
+    if (slack < 0) {
+        ++this->stats.missed;
+    }
+    ++this->stats.frames;
+}
+
+void GC9A01FrameScheduler::ResetStats() {
+    memset(&this->stats, 0, sizeof(this->stats));
+}
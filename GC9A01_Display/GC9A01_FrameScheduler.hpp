@@ -0,0 +1,93 @@
+#ifndef GC9A01_FRAME_SCHEDULER_HPP
+#define GC9A01_FRAME_SCHEDULER_HPP
+
+#include "GC9A01.hpp"
+
+typedef struct {
+    // Frames paced by BeginFrame / EndFrame
+    unsigned long frames;
+    // Frames whose transfer was still running when the scan came back to their first row
+    unsigned long missed;
+    // BeginFrame calls that saw no TE edge in time (TE not wired or panel asleep), those frames are not paced
+    unsigned long timeouts;
+    // TE edge to end of the transfer of the last frame
+    unsigned long long lastDurationUs;
+    // Smallest time left before the deadline over all frames, negative once a deadline was missed
+    long long worstSlackUs;
+} GC9A01FrameStats;
+
+/* Paces updates with the Tearing Effect (TE) output of the panel so they do not tear.
+ *
+ * The panel refreshes its rows top to bottom once per frame. An update that starts right after the scan has passed
+ * its first row and ends before the scan comes back to it (one frame period later) is never shown half written: the
+ * scan stays ahead of the transfer all along. Start() points the TE line (SetTearLine) one row below the first row
+ * of the update and BeginFrame() waits for the TE edge, taken as a rising edge interrupt on te_pin. EndFrame()
+ * waits for the transfer and books it against the deadline. The frame period is measured from the TE edges.
+ *
+ * This works for updates that take longer than the scan of their rows, which is the case for large updates (at
+ * 60 Hz the scan spends about 65 us per row, one 240 pixel row at 16 bits takes 96 us at 40 MHz). Smaller updates
+ * do not need pacing.
+ *
+ * On the RP2040 the edges come from the IO_IRQ_BANK0 interrupt (a shared handler installed with the first
+ * scheduler, the application can keep its own GPIO callback). On the host build (GC9A01_HOST) they come from the TE timer of the attached GC9A01Emulator, and as
+ * for GC9A01DMA the "IRQ" fires when the scheduler polls.
+ * */
+class GC9A01FrameScheduler
+{
+private:
+    const GC9A01& display;
+    unsigned char te_pin;
+    unsigned char pulseWidth;
+    bool running;
+    unsigned short firstRow;
+    // Written from the TE interrupt
+    volatile unsigned long edgeCount;
+    volatile unsigned long long lastEdgeUs;
+    volatile unsigned long long periodUs;
+    // The edge before lastEdgeUs is one frame earlier, false after a tear line change
+    volatile bool periodValid;
+    // TE edge the frame started at and the time its transfer has to be done by
+    unsigned long long frameStartUs;
+    unsigned long long deadlineUs;
+    bool framePaced;
+    GC9A01FrameStats stats;
+#ifdef GC9A01_HOST
+    // Emulated time up to which the TE edges have been delivered
+    unsigned long long hostServicedNs;
+    void HostService();
+#else
+    static void IrqHandler();
+#endif
+    void OnTearingEffect(unsigned long long timeUs);
+    // lastEdgeUs and periodUs read together, not torn by an edge in between (two 32 bit loads each on the RP2040)
+    void ReadEdgeTimes(unsigned long long* lastEdge, unsigned long long* period) const;
+    // Blocks until the next TE edge, false after timeoutUs without one
+    bool WaitForEdge(unsigned long long timeoutUs);
+public:
+    /* @param te_pin GPIO the TE output of the panel is wired to
+     * @param pulseWidth TE pulse width in lines minus one (SetTearingEffectControl)
+     * */
+    GC9A01FrameScheduler(const GC9A01& display, unsigned char te_pin, unsigned char pulseWidth = 0x01U);
+    ~GC9A01FrameScheduler();
+    // Turns the TE output on (positive pulse, V-Blanking only) and enables the pin interrupt
+    void Start();
+    // Turns the TE output and the pin interrupt off
+    void Stop();
+    // Moves the TE line so that frames start behind the scan of row, the update area should start there
+    void SetFirstRow(unsigned short row);
+
+    /* Waits until the scan has just passed the first row, then transfers can start. The deadline is one frame
+     * period later. Returns false (the frame goes out unpaced) when no TE edge came within two frame periods.
+     * */
+    bool BeginFrame();
+    // Waits for the asynchronous transfer in flight, if any, and books the frame (also calls GC9A01::MarkFrame)
+    void EndFrame();
+
+    // Measured time between TE edges, 0 until two edges were seen
+    unsigned long long GetFramePeriodUs() const;
+    inline unsigned long GetEdgeCount() const { return this->edgeCount; }
+    inline const GC9A01FrameStats& GetStats() const { return this->stats; }
+    void ResetStats();
+};
+
+#endif
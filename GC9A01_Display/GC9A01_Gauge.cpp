@@ -0,0 +1,334 @@
+#include "GC9A01_Gauge.hpp"
+#include "GC9A01_Trig.hpp"
+
+namespace {
+    // Distances are Q6 (1/64 pixel), directions Q14
+    constexpr int DISTANCE_SHIFT = 6;
+    constexpr int HALF_PIXEL = 1 << (DISTANCE_SHIFT - 1);
+    constexpr int FAR = 1 << 24;
+
+    inline int Min(int a, int b) { return (a < b) ? a : b; }
+    inline int Max(int a, int b) { return (a > b) ? a : b; }
+    inline int Abs(int a) { return (a < 0) ? -a : a; }
+
+    // Length of (x, y), in the unit of x and y
+    inline int Length(int x, int y) {
+        return static_cast<int>(GC9A01Trig::ISqrt(static_cast<unsigned int>(x * x + y * y)));
+    }
+
+    // Share of a pixel covered by a shape whose edge is distance away (positive outside), 0 to 256
+    inline int Coverage(int distance) {
+        const int coverage = HALF_PIXEL - distance;
+        return (coverage <= 0) ? 0 : ((coverage >= (1 << DISTANCE_SHIFT)) ? 256 : (coverage << (8 - DISTANCE_SHIFT)));
+    }
+
+    inline void Blend(unsigned char rgb[], const unsigned char color[], int coverage) {
+        if (0 == coverage) {
+            return;
+        }
+        for (unsigned int c = 0U; c < RGB_COUNT; ++c) {
+            rgb[c] += ((color[c] - rgb[c]) * coverage) >> 8;
+        }
+    }
+}
+
+GC9A01Gauge::GC9A01Gauge(const GC9A01& display, unsigned char buffer[], size_t bufferSize, short cx, short cy)
+ : display(display), buffer(buffer), bufferSize(bufferSize), cx(cx), cy(cy), startAngle(GC9A01Trig::FromDegrees(225)),
+   sweep(GC9A01Trig::FULL_TURN * 3U / 4U), arcRadius(112), arcThickness(12), needleLength(96), needleWidth(6), hubRadius(10),
+   minValue(0), maxValue(100), value(0), background{0U, 0U, 0U}, trackColor{48U, 48U, 48U}, valueColor{0U, 160U, 255U},
+   needleColor{255U, 64U, 0U}, hubColor{200U, 200U, 200U}, lastPixels(0U), lastWindows(0U) { }
+
+void GC9A01Gauge::SetScale(int startAngle, int sweep) {
+    this->startAngle = GC9A01Trig::FromDegrees(startAngle);
+    this->sweep = (sweep >= 360) ? GC9A01Trig::FULL_TURN : ((sweep <= 0) ? 0U : ((sweep * GC9A01Trig::FULL_TURN) / 360U));
+}
+
+void GC9A01Gauge::SetRange(int minValue, int maxValue) {
+    this->minValue = minValue;
+    this->maxValue = maxValue;
+}
+
+void GC9A01Gauge::SetArc(short radius, short thickness) {
+    this->arcRadius = radius;
+    this->arcThickness = thickness;
+}
+
+void GC9A01Gauge::SetNeedle(short length, short width, short hubRadius) {
+    this->needleLength = length;
+    this->needleWidth = width;
+    this->hubRadius = hubRadius;
+}
+
+void GC9A01Gauge::SetBackground(unsigned char r, unsigned char g, unsigned char b) {
+    this->background[0] = r;
+    this->background[1] = g;
+    this->background[2] = b;
+}
+
+void GC9A01Gauge::SetTrackColor(unsigned char r, unsigned char g, unsigned char b) {
+    this->trackColor[0] = r;
+    this->trackColor[1] = g;
+    this->trackColor[2] = b;
+}
+
+void GC9A01Gauge::SetValueColor(unsigned char r, unsigned char g, unsigned char b) {
+    this->valueColor[0] = r;
+    this->valueColor[1] = g;
+    this->valueColor[2] = b;
+}
+
+void GC9A01Gauge::SetNeedleColor(unsigned char r, unsigned char g, unsigned char b) {
+    this->needleColor[0] = r;
+    this->needleColor[1] = g;
+    this->needleColor[2] = b;
+}
+
+void GC9A01Gauge::SetHubColor(unsigned char r, unsigned char g, unsigned char b) {
+    this->hubColor[0] = r;
+    this->hubColor[1] = g;
+    this->hubColor[2] = b;
+}
+
+GC9A01Gauge::Sector GC9A01Gauge::MakeSector(unsigned short start, unsigned int sweep) {
+    const unsigned short end = start + sweep;
+    Sector sector;
+    sector.startX = GC9A01Trig::Sin(start);
+    sector.startY = -GC9A01Trig::Cos(start);
+    sector.endX = GC9A01Trig::Sin(end);
+    sector.endY = -GC9A01Trig::Cos(end);
+    sector.wide = sweep > (GC9A01Trig::FULL_TURN / 2U);
+    sector.full = sweep >= GC9A01Trig::FULL_TURN;
+    return sector;
+}
+
+unsigned short GC9A01Gauge::GetAngle(int value) const {
+    if (this->maxValue <= this->minValue) {
+        return this->startAngle;
+    }
+    const int clamped = Min(Max(value, this->minValue), this->maxValue);
+    const unsigned long long offset = (static_cast<unsigned long long>(this->sweep) * (clamped - this->minValue)) / (this->maxValue - this->minValue);
+    return this->startAngle + static_cast<unsigned short>(offset);
+}
+
+int GC9A01Gauge::GetReach() const {
+    return Max(Max(this->arcRadius, this->needleLength + (this->needleWidth + 1) / 2), this->hubRadius) + 1;
+}
+
+bool GC9A01Gauge::InRegion(int px, int py, const Region& region) const {
+    if ((px * px + py * py) > (region.radius * region.radius)) {
+        return false;
+    }
+    // Needles with two pixels of margin
+    const int margin = (this->needleWidth / 2 + 2) * GC9A01Trig::ONE;
+    for (unsigned int i = 0U; i < 2U; ++i) {
+        const int along = px * region.needleX[i] + py * region.needleY[i];
+        const int across = Abs(px * region.needleY[i] - py * region.needleX[i]);
+        if ((along >= -margin) && (along <= (this->needleLength * GC9A01Trig::ONE + margin)) && (across <= margin)) {
+            return true;
+        }
+    }
+    if (region.sector.full) {
+        return true;
+    }
+    // The sector widened by a pixel and a half, the anti-aliased ends of the value arc move with it
+    const int widen = 3 << 13;
+    const bool afterStart = (region.sector.startX * py - region.sector.startY * px) >= -widen;
+    const bool beforeEnd = (px * region.sector.endY - py * region.sector.endX) >= -widen;
+    return region.sector.wide ? (afterStart || beforeEnd) : (afterStart && beforeEnd);
+}
+
+void GC9A01Gauge::Shade(int px, int py, const Frame& frame, unsigned char rgb[]) const {
+    rgb[0] = this->background[0];
+    rgb[1] = this->background[1];
+    rgb[2] = this->background[2];
+
+    const int x = px * (1 << DISTANCE_SHIFT);
+    const int y = py * (1 << DISTANCE_SHIFT);
+    const int radius = Length(x, y);
+
+    // Arcs: inside the ring and inside the sector, each edge is the distance to it
+    const int outer = this->arcRadius * (1 << DISTANCE_SHIFT) + HALF_PIXEL;
+    const int inner = (this->arcRadius - this->arcThickness) * (1 << DISTANCE_SHIFT) + HALF_PIXEL;
+    const int ring = Max(radius - outer, inner - radius);
+    if (ring < HALF_PIXEL) {
+        const Sector* const sectors[2] = {&frame.scale, frame.hasValue ? &frame.value : nullptr};
+        const unsigned char* const colors[2] = {this->trackColor, this->valueColor};
+        for (unsigned int i = 0U; i < 2U; ++i) {
+            const Sector* const sector = sectors[i];
+            if (nullptr == sector) {
+                continue;
+            }
+            int distance = ring;
+            if (!sector->full) {
+                const int fromStart = -((sector->startX * py - sector->startY * px) >> (14 - DISTANCE_SHIFT));
+                const int toEnd = -((px * sector->endY - py * sector->endX) >> (14 - DISTANCE_SHIFT));
+                distance = Max(ring, sector->wide ? Min(fromStart, toEnd) : Max(fromStart, toEnd));
+            }
+            Blend(rgb, colors[i], Coverage(distance));
+        }
+    }
+
+    // Needle: distance to the segment from the center to the tip, less half the width
+    const int along = px * frame.needleX + py * frame.needleY;
+    int needle = radius;
+    if (along >= (this->needleLength * GC9A01Trig::ONE)) {
+        const int tipX = (frame.needleX * this->needleLength) >> (14 - DISTANCE_SHIFT);
+        const int tipY = (frame.needleY * this->needleLength) >> (14 - DISTANCE_SHIFT);
+        needle = Length(x - tipX, y - tipY);
+    } else if (along > 0) {
+        needle = Abs(px * frame.needleY - py * frame.needleX) >> (14 - DISTANCE_SHIFT);
+    }
+    Blend(rgb, this->needleColor, Coverage(needle - this->needleWidth * HALF_PIXEL));
+
+    Blend(rgb, this->hubColor, Coverage(radius - this->hubRadius * (1 << DISTANCE_SHIFT) - HALF_PIXEL));
+}
+
+void GC9A01Gauge::Render(const Region& region) {
+    this->lastPixels = 0U;
+    this->lastWindows = 0U;
+    if (this->bufferSize < (MAX_WIDTH * RGB_COUNT)) {
+        return;
+    }
+
+    const unsigned short needleAngle = this->GetAngle(this->value);
+    const unsigned int valueSweep = static_cast<unsigned short>(needleAngle - this->startAngle);
+    Frame frame;
+    frame.scale = MakeSector(this->startAngle, this->sweep);
+    frame.value = MakeSector(this->startAngle, valueSweep);
+    frame.hasValue = (0U != valueSweep) || ((this->value >= this->maxValue) && (GC9A01Trig::FULL_TURN == this->sweep));
+    if (frame.hasValue && (0U == valueSweep)) {
+        // Full scale of a full turn
+        frame.value.full = true;
+    }
+    frame.needleX = GC9A01Trig::Sin(needleAngle);
+    frame.needleY = -GC9A01Trig::Cos(needleAngle);
+
+    // Bounding box of the region, relative to the center
+    int left = -region.radius;
+    int right = region.radius;
+    int top = -region.radius;
+    int bottom = region.radius;
+    if (!region.sector.full) {
+        // Center, both ends of the sector, the compass points it sweeps over and both needles
+        const int reach = region.radius + 2;
+        const int margin = this->needleWidth / 2 + 3;
+        const int pointsX[] = {0, (region.sector.startX * reach) >> 14, (region.sector.endX * reach) >> 14, 0, reach, 0, -reach,
+                               (region.needleX[0] * this->needleLength) >> 14, (region.needleX[1] * this->needleLength) >> 14};
+        const int pointsY[] = {0, (region.sector.startY * reach) >> 14, (region.sector.endY * reach) >> 14, -reach, 0, reach, 0,
+                               (region.needleY[0] * this->needleLength) >> 14, (region.needleY[1] * this->needleLength) >> 14};
+        left = FAR;
+        right = -FAR;
+        top = FAR;
+        bottom = -FAR;
+        for (unsigned int i = 0U; i < (sizeof(pointsX) / sizeof(pointsX[0])); ++i) {
+            if ((3U <= i) && (i < 7U)) {
+                const bool afterStart = (region.sector.startX * pointsY[i] - region.sector.startY * pointsX[i]) >= 0;
+                const bool beforeEnd = (pointsX[i] * region.sector.endY - pointsY[i] * region.sector.endX) >= 0;
+                if (!(region.sector.wide ? (afterStart || beforeEnd) : (afterStart && beforeEnd))) {
+                    continue;
+                }
+            }
+            left = Min(left, pointsX[i] - margin);
+            right = Max(right, pointsX[i] + margin);
+            top = Min(top, pointsY[i] - margin);
+            bottom = Max(bottom, pointsY[i] + margin);
+        }
+    }
+    left = Max(left, -this->cx);
+    right = Min(right, MAX_WIDTH - 1 - this->cx);
+    top = Max(top, -this->cy);
+    bottom = Min(bottom, MAX_HEIGHT - 1 - this->cy);
+
+    // Rows of the region, grouped into bands as wide as their widest row while they fit the buffer
+    this->display.BeginTransaction();
+    int bandTop = 0;
+    int bandRows = 0;
+    int bandLeft = 0;
+    int bandRight = 0;
+    for (int py = top; py <= (bottom + 1); ++py) {
+        int rowLeft = right + 1;
+        int rowRight = left - 1;
+        if (py <= bottom) {
+            for (int px = left; px <= right; ++px) {
+                if (this->InRegion(px, py, region)) {
+                    rowLeft = px;
+                    break;
+                }
+            }
+            for (int px = right; px >= rowLeft; --px) {
+                if (this->InRegion(px, py, region)) {
+                    rowRight = px;
+                    break;
+                }
+            }
+        }
+        const bool empty = rowLeft > rowRight;
+        const int newLeft = Min(bandLeft, rowLeft);
+        const int newRight = Max(bandRight, rowRight);
+        const bool fits = !empty && (static_cast<size_t>((newRight - newLeft + 1) * (bandRows + 1) * RGB_COUNT) <= this->bufferSize);
+
+        if ((0 < bandRows) && !fits) {
+            const int width = bandRight - bandLeft + 1;
+            unsigned char* pixel = this->buffer;
+            for (int row = bandTop; row < (bandTop + bandRows); ++row) {
+                for (int px = bandLeft; px <= bandRight; ++px) {
+                    this->Shade(px, row, frame, pixel);
+                    pixel += RGB_COUNT;
+                }
+            }
+            this->display.FillImage(this->buffer, this->cx + bandLeft, this->cy + bandTop, width, bandRows);
+            this->lastPixels += width * bandRows;
+            ++this->lastWindows;
+            bandRows = 0;
+        }
+        if (empty) {
+            continue;
+        }
+        if (0 == bandRows) {
+            bandTop = py;
+            bandLeft = rowLeft;
+            bandRight = rowRight;
+        } else {
+            bandLeft = newLeft;
+            bandRight = newRight;
+        }
+        ++bandRows;
+    }
+    this->display.EndTransaction();
+}
+
+void GC9A01Gauge::Draw(int value) {
+    this->value = Min(Max(value, this->minValue), this->maxValue);
+    Region region;
+    region.radius = this->GetReach() + 1;
+    region.sector = MakeSector(0U, GC9A01Trig::FULL_TURN);
+    region.needleX[0] = 0;
+    region.needleY[0] = 0;
+    region.needleX[1] = 0;
+    region.needleY[1] = 0;
+    this->Render(region);
+}
+
+void GC9A01Gauge::MoveTo(int value) {
+    const int clamped = Min(Max(value, this->minValue), this->maxValue);
+    if (clamped == this->value) {
+        this->lastPixels = 0U;
+        this->lastWindows = 0U;
+        return;
+    }
+    const unsigned short from = this->GetAngle(this->value);
+    const unsigned short to = this->GetAngle(clamped);
+    // Offsets along the scale, which runs clockwise from its start
+    const unsigned short fromOffset = from - this->startAngle;
+    const unsigned short toOffset = to - this->startAngle;
+
+    Region region;
+    region.radius = this->GetReach() + 1;
+    region.sector = MakeSector(this->startAngle + Min(fromOffset, toOffset), Abs(toOffset - fromOffset));
+    region.needleX[0] = GC9A01Trig::Sin(from);
+    region.needleY[0] = -GC9A01Trig::Cos(from);
+    region.needleX[1] = GC9A01Trig::Sin(to);
+    region.needleY[1] = -GC9A01Trig::Cos(to);
+    this->value = clamped;
+    this->Render(region);
+}
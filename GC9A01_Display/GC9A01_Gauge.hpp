@@ -0,0 +1,101 @@
+#ifndef GC9A01_GAUGE_HPP
+#define GC9A01_GAUGE_HPP
+
+#include "GC9A01.hpp"
+
+/* Anti-aliased dial: a track arc over the scale, a value arc from the start of the scale to the needle, the
+ * needle (a round ended bar from the center) and a hub, over a plain background.
+ *
+ * Every pixel is shaded from its distance to each shape (fixed point, see GC9A01Trig), a pixel on an edge gets
+ * the share of the shape color it is covered by. Rows are rendered into a small RGB888 buffer as bands and sent
+ * with FillImage.
+ *
+ * MoveTo only redraws the area the move affects: the sector between the old and the new needle angle plus both
+ * needles. A move of a few degrees sends a few thousand pixels instead of the whole dial.
+ * */
+class GC9A01Gauge
+{
+private:
+    // Directions (Q14, clockwise from 12 o'clock) bounding a sector, wide when it sweeps more than half a turn
+    typedef struct {
+        int startX;
+        int startY;
+        int endX;
+        int endY;
+        bool wide;
+        bool full;
+    } Sector;
+
+    // Shape directions of the value being drawn, worked out once per draw
+    typedef struct {
+        Sector scale;
+        Sector value;
+        bool hasValue;
+        int needleX;
+        int needleY;
+    } Frame;
+
+    // Area to redraw: within radius of the center and in the sector (widened by a pixel), or near either needle
+    typedef struct {
+        int radius;
+        Sector sector;
+        int needleX[2];
+        int needleY[2];
+    } Region;
+
+    const GC9A01& display;
+    unsigned char* buffer;
+    size_t bufferSize;
+    short cx;
+    short cy;
+    unsigned short startAngle;
+    unsigned int sweep;
+    short arcRadius;
+    short arcThickness;
+    short needleLength;
+    short needleWidth;
+    short hubRadius;
+    int minValue;
+    int maxValue;
+    int value;
+    unsigned char background[RGB_COUNT];
+    unsigned char trackColor[RGB_COUNT];
+    unsigned char valueColor[RGB_COUNT];
+    unsigned char needleColor[RGB_COUNT];
+    unsigned char hubColor[RGB_COUNT];
+    size_t lastPixels;
+    size_t lastWindows;
+
+    static Sector MakeSector(unsigned short start, unsigned int sweep);
+    unsigned short GetAngle(int value) const;
+    // Furthest any shape reaches from the center, in pixels
+    int GetReach() const;
+    bool InRegion(int px, int py, const Region& region) const;
+    void Shade(int px, int py, const Frame& frame, unsigned char rgb[]) const;
+    void Render(const Region& region);
+public:
+    /* @param buffer RGB888 band buffer, at least MAX_WIDTH * RGB_COUNT bytes, word aligned for the fast conversion path
+     * @param cx, cy center of the dial
+     * */
+    GC9A01Gauge(const GC9A01& display, unsigned char buffer[], size_t bufferSize, short cx = MAX_WIDTH / 2U, short cy = MAX_HEIGHT / 2U);
+    // Scale from startAngle over sweep degrees, clockwise from 12 o'clock (225 and 270 by default)
+    void SetScale(int startAngle, int sweep);
+    void SetRange(int minValue, int maxValue);
+    void SetArc(short radius, short thickness);
+    void SetNeedle(short length, short width, short hubRadius);
+    void SetBackground(unsigned char r, unsigned char g, unsigned char b);
+    void SetTrackColor(unsigned char r, unsigned char g, unsigned char b);
+    void SetValueColor(unsigned char r, unsigned char g, unsigned char b);
+    void SetNeedleColor(unsigned char r, unsigned char g, unsigned char b);
+    void SetHubColor(unsigned char r, unsigned char g, unsigned char b);
+    inline int GetValue() const { return this->value; }
+    // Draws the whole dial at value
+    void Draw(int value);
+    // Moves the needle to value, redrawing only what changes
+    void MoveTo(int value);
+    // Pixels and windows sent by the last Draw or MoveTo
+    inline size_t GetLastPixels() const { return this->lastPixels; }
+    inline size_t GetLastWindows() const { return this->lastWindows; }
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifdef GC9A01_HOST
+
+#include <chrono>
+#include "GC9A01_HAL.hpp"
+#include "GC9A01_Emulator.hpp"
+
+static GC9A01Emulator* attachedEmulator = nullptr;
+
+static unsigned long long SteadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+namespace GC9A01HAL {
+    void Attach(GC9A01Emulator* emulator) {
+        attachedEmulator = emulator;
+    }
+
+    GC9A01Emulator* GetEmulator() {
+        return attachedEmulator;
+    }
+
+    void SpiInit(spi_inst_t* spi, unsigned int baudRate) {
+        (void)spi;
+        if (nullptr != attachedEmulator) {
+            attachedEmulator->SetSpiClockHz(baudRate);
+        }
+    }
+
+    void SpiWrite(spi_inst_t* spi, const unsigned char data[], size_t dataSize) {
+        (void)spi;
+        if (nullptr != attachedEmulator) {
+            attachedEmulator->SpiWrite(data, dataSize);
+        }
+    }
+
+    void PinFunctionSio(unsigned char pin) { (void)pin; }
+
+    void PinFunctionSpi(unsigned char pin) { (void)pin; }
+
+    void PinOutput(unsigned char pin) { (void)pin; }
+
+    void PinInput(unsigned char pin) { (void)pin; }
+
+    void PinPut(unsigned char pin, bool value) {
+        if (nullptr != attachedEmulator) {
+            attachedEmulator->SetPin(pin, value);
+        }
+    }
+
+    void SleepMs(unsigned int ms) {
+        if (nullptr != attachedEmulator) {
+            attachedEmulator->Sleep(ms * 1000000ULL);
+        }
+    }
+
+    unsigned long long TimeNs() {
+        return (nullptr != attachedEmulator) ? attachedEmulator->NowNs() : SteadyNowNs();
+    }
+
+    unsigned long long TimeUs() {
+        return TimeNs() / 1000U;
+    }
+
+    void WaitUntilNs(unsigned long long timeNs) {
+        if (nullptr != attachedEmulator) {
+            attachedEmulator->WaitUntilNs(timeNs);
+        }
+    }
+
+    unsigned long long ScheduleTransfer(spi_inst_t* spi, size_t dataSize) {
+        (void)spi;
+        return (nullptr != attachedEmulator) ? attachedEmulator->ScheduleTransfer(dataSize) : TimeNs();
+    }
+
+    void DeliverTransfer(spi_inst_t* spi, const unsigned char data[], size_t dataSize) {
+        (void)spi;
+        if (nullptr != attachedEmulator) {
+            attachedEmulator->Receive(data, dataSize);
+        }
+    }
+}
+
+#endif
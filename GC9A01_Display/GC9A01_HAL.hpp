@@ -0,0 +1,80 @@
+#ifndef GC9A01_HAL_HPP
+#define GC9A01_HAL_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Everything the driver needs from the platform: one SPI instance, three GPIOs and a clock.
+ *
+ * On the RP2040 these are inline forwards to the pico SDK, so the seam costs nothing.
+ * With GC9A01_HOST defined they are implemented in GC9A01_HAL.cpp on top of an attached
+ * GC9A01Emulator, which lets the driver be built, profiled and benchmarked on a PC.
+ * */
+
+#ifdef GC9A01_HOST
+
+typedef struct spi_inst spi_inst_t;
+
+// Same base addresses as on the RP2040, only used to tell the instances apart
+#define spi0 (reinterpret_cast<spi_inst_t*>(static_cast<uintptr_t>(0x4003C000U)))
+#define spi1 (reinterpret_cast<spi_inst_t*>(static_cast<uintptr_t>(0x40040000U)))
+
+class GC9A01Emulator;
+
+namespace GC9A01HAL {
+    void SpiInit(spi_inst_t* spi, unsigned int baudRate);
+    void SpiWrite(spi_inst_t* spi, const unsigned char data[], size_t dataSize);
+    // The host model works on bytes, repeated transfers are expanded before they reach the emulator
+    inline void SpiSetFrameBits(spi_inst_t* spi, unsigned int bits) { (void)spi; (void)bits; }
+    void PinFunctionSio(unsigned char pin);
+    void PinFunctionSpi(unsigned char pin);
+    void PinOutput(unsigned char pin);
+    void PinInput(unsigned char pin);
+    void PinPut(unsigned char pin, bool value);
+    void SleepMs(unsigned int ms);
+    unsigned long long TimeUs();
+
+    // Route every bus and pin access to emulator (nullptr detaches, accesses are then dropped)
+    void Attach(GC9A01Emulator* emulator);
+    GC9A01Emulator* GetEmulator();
+
+    // Used by the simulated DMA engine
+    unsigned long long TimeNs();
+    void WaitUntilNs(unsigned long long timeNs);
+    // Reserve the bus for dataSize bytes, returns the time at which the last byte has been shifted out
+    unsigned long long ScheduleTransfer(spi_inst_t* spi, size_t dataSize);
+    // Deliver the payload of a transfer previously scheduled with ScheduleTransfer
+    void DeliverTransfer(spi_inst_t* spi, const unsigned char data[], size_t dataSize);
+}
+
+#else
+
+#include "pico/stdlib.h"
+#include "hardware/spi.h"
+
+namespace GC9A01HAL {
+    inline void SpiInit(spi_inst_t* spi, unsigned int baudRate) {
+        spi_init(spi, baudRate);
+        spi_set_format(
+            spi,
+            8,              // bits
+            SPI_CPOL_0,     // CPOL = 0
+            SPI_CPHA_0,     // CPHA = 0
+            SPI_MSB_FIRST
+        );
+    }
+    inline void SpiWrite(spi_inst_t* spi, const unsigned char data[], size_t dataSize) { spi_write_blocking(spi, data, dataSize); }
+    // Only called while the bus is idle, 12 and 16 bit frames let DMA repeat a pixel without a buffer
+    inline void SpiSetFrameBits(spi_inst_t* spi, unsigned int bits) { spi_set_format(spi, bits, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST); }
+    inline void PinFunctionSio(unsigned char pin) { gpio_set_function(pin, GPIO_FUNC_SIO); }
+    inline void PinFunctionSpi(unsigned char pin) { gpio_set_function(pin, GPIO_FUNC_SPI); }
+    inline void PinOutput(unsigned char pin) { gpio_set_dir(pin, GPIO_OUT); }
+    inline void PinInput(unsigned char pin) { gpio_set_dir(pin, GPIO_IN); }
+    inline void PinPut(unsigned char pin, bool value) { gpio_put(pin, value); }
+    inline void SleepMs(unsigned int ms) { sleep_ms(ms); }
+    inline unsigned long long TimeUs() { return time_us_64(); }
+}
+
+#endif
+
+#endif
@@ -0,0 +1,588 @@
+#ifndef GC9A01_PIXEL_KERNELS_HPP
+#define GC9A01_PIXEL_KERNELS_HPP
+
+#include <stdint.h>
+#include <string.h>
+#include "GC9A01.hpp"
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "The word kernels assume a little endian core (RP2040, x86)");
+
+/* RGB888 -> panel format conversion kernels, one instance per PixelFormat and ColorOrder so that
+ * nothing is decided per pixel. A kernel converts a whole run of pixels: the bulk goes through blocks
+ * that load and store 32-bit words, the remainder goes pixel by pixel.
+ *
+ * Wire formats (MSB first):
+ * 12 bits: RRRRGGGG BBBBRRRR GGGGBBBB (two pixels in three bytes, an odd last pixel is padded to two bytes)
+ * 16 bits: RRRRRGGG GGGBBBBB
+ * 18 bits: RRRRRR00 GGGGGG00 BBBBBB00
+ * */
+namespace GC9A01Kernels {
+    typedef size_t (*ConvertFunction)(const unsigned char rgb[], size_t pixelCount, unsigned char out[]);
+
+    // Number of bytes pixelCount pixels take on the wire
+    constexpr size_t OutputSize(PixelFormat pf, size_t pixelCount) {
+        return (PF12BitsPerPixel == pf) ? ((pixelCount * 3U + 1U) / 2U) :
+               (PF16BitsPerPixel == pf) ? (pixelCount * 2U) :
+                                          (pixelCount * 3U);
+    }
+
+    // The Cortex-M0+ faults on unaligned word accesses, word blocks are only used on aligned buffers
+    inline bool IsWordAligned(const void* in, const void* out) {
+        return 0U == ((reinterpret_cast<uintptr_t>(in) | reinterpret_cast<uintptr_t>(out)) & 0x03U);
+    }
+
+    inline uint32_t LoadWord(const unsigned char* p) {
+        uint32_t word;
+        memcpy(&word, __builtin_assume_aligned(p, 4U), 4U);
+        return word;
+    }
+
+    inline void StoreWord(unsigned char* p, uint32_t word) {
+        memcpy(__builtin_assume_aligned(p, 4U), &word, 4U);
+    }
+
+    // Byte n of a little endian word, i.e. the byte at offset n in memory
+    inline unsigned int Byte(uint32_t word, unsigned int n) {
+        return (word >> (8U * n)) & 0xFFU;
+    }
+
+    template <PixelFormat PF, ColorOrder ORDER>
+    struct Kernel;
+
+    template <ColorOrder ORDER>
+    struct Kernel<PF12BitsPerPixel, ORDER> {
+        // 8 pixels: 6 words in, 3 words out
+        static constexpr size_t BLOCK_PIXELS = 8U;
+
+        // Two pixels (channels c0, c1, c2 as stored in the source) as three wire bytes, first byte in the low bits
+        static inline uint32_t Pair(unsigned int a0, unsigned int a1, unsigned int a2, unsigned int b0, unsigned int b1, unsigned int b2) {
+            const unsigned int firstA = (ColorOrderRGB == ORDER) ? a0 : a2;
+            const unsigned int lastA = (ColorOrderRGB == ORDER) ? a2 : a0;
+            const unsigned int firstB = (ColorOrderRGB == ORDER) ? b0 : b2;
+            const unsigned int lastB = (ColorOrderRGB == ORDER) ? b2 : b0;
+            return ((firstA & 0xF0U) | (a1 >> 4U)) |
+                   (((lastA & 0xF0U) | (firstB >> 4U)) << 8U) |
+                   (((b1 & 0xF0U) | (lastB >> 4U)) << 16U);
+        }
+
+        // First and second pair of the four pixels held by three consecutive source words
+        static inline uint32_t PairLow(uint32_t w0, uint32_t w1) {
+            return Pair(Byte(w0, 0U), Byte(w0, 1U), Byte(w0, 2U), Byte(w0, 3U), Byte(w1, 0U), Byte(w1, 1U));
+        }
+        static inline uint32_t PairHigh(uint32_t w1, uint32_t w2) {
+            return Pair(Byte(w1, 2U), Byte(w1, 3U), Byte(w2, 0U), Byte(w2, 1U), Byte(w2, 2U), Byte(w2, 3U));
+        }
+
+        static size_t ConvertRow(const unsigned char rgb[], size_t pixelCount, unsigned char out[]) {
+            constexpr size_t FIRST = (ColorOrderRGB == ORDER) ? 0U : 2U;
+            constexpr size_t LAST = 2U - FIRST;
+            size_t i = 0U;
+            unsigned char* o = out;
+
+            if (IsWordAligned(rgb, out)) {
+                for (; (i + BLOCK_PIXELS) <= pixelCount; i += BLOCK_PIXELS) {
+                    const unsigned char* const px = &rgb[i * 3U];
+                    const uint32_t w0 = LoadWord(px);
+                    const uint32_t w1 = LoadWord(px + 4U);
+                    const uint32_t w2 = LoadWord(px + 8U);
+                    const uint32_t w3 = LoadWord(px + 12U);
+                    const uint32_t w4 = LoadWord(px + 16U);
+                    const uint32_t w5 = LoadWord(px + 20U);
+                    const uint32_t q0 = PairLow(w0, w1);
+                    const uint32_t q1 = PairHigh(w1, w2);
+                    const uint32_t q2 = PairLow(w3, w4);
+                    const uint32_t q3 = PairHigh(w4, w5);
+                    StoreWord(o, q0 | (q1 << 24U));
+                    StoreWord(o + 4U, (q1 >> 8U) | (q2 << 16U));
+                    StoreWord(o + 8U, (q2 >> 16U) | (q3 << 8U));
+                    o += 12U;
+                }
+            }
+            for (; (i + 2U) <= pixelCount; i += 2U) {
+                const unsigned char* const px = &rgb[i * 3U];
+                const uint32_t q = Pair(px[0U], px[1U], px[2U], px[3U], px[4U], px[5U]);
+                o[0] = Byte(q, 0U);
+                o[1] = Byte(q, 1U);
+                o[2] = Byte(q, 2U);
+                o += 3U;
+            }
+            if (i < pixelCount) {
+                // Odd last pixel, the panel ignores the padding nibble when the write ends. Read before writing, a
+                // single pixel converted in place overlaps its own output
+                const unsigned char* const px = &rgb[i * 3U];
+                const unsigned char first = (px[FIRST] & 0xF0U) | (px[1U] >> 4U);
+                const unsigned char last = px[LAST] & 0xF0U;
+                o[0] = first;
+                o[1] = last;
+                o += 2U;
+            }
+            return o - out;
+        }
+    };
+
+    template <ColorOrder ORDER>
+    struct Kernel<PF16BitsPerPixel, ORDER> {
+        // 4 pixels: 3 words in, 2 words out
+        static constexpr size_t BLOCK_PIXELS = 4U;
+
+        // One pixel as two wire bytes, first byte in the low bits
+        static inline uint32_t Pixel(unsigned int c0, unsigned int c1, unsigned int c2) {
+            const unsigned int first = (ColorOrderRGB == ORDER) ? c0 : c2;
+            const unsigned int last = (ColorOrderRGB == ORDER) ? c2 : c0;
+            return ((first & 0xF8U) | (c1 >> 5U)) | ((((c1 << 3U) & 0xE0U) | (last >> 3U)) << 8U);
+        }
+
+        static size_t ConvertRow(const unsigned char rgb[], size_t pixelCount, unsigned char out[]) {
+            size_t i = 0U;
+            unsigned char* o = out;
+
+            if (IsWordAligned(rgb, out)) {
+                for (; (i + BLOCK_PIXELS) <= pixelCount; i += BLOCK_PIXELS) {
+                    const unsigned char* const px = &rgb[i * 3U];
+                    const uint32_t w0 = LoadWord(px);
+                    const uint32_t w1 = LoadWord(px + 4U);
+                    const uint32_t w2 = LoadWord(px + 8U);
+                    StoreWord(o, Pixel(Byte(w0, 0U), Byte(w0, 1U), Byte(w0, 2U)) | (Pixel(Byte(w0, 3U), Byte(w1, 0U), Byte(w1, 1U)) << 16U));
+                    StoreWord(o + 4U, Pixel(Byte(w1, 2U), Byte(w1, 3U), Byte(w2, 0U)) | (Pixel(Byte(w2, 1U), Byte(w2, 2U), Byte(w2, 3U)) << 16U));
+                    o += 8U;
+                }
+            }
+            for (; i < pixelCount; ++i) {
+                const unsigned char* const px = &rgb[i * 3U];
+                const uint32_t packed = Pixel(px[0U], px[1U], px[2U]);
+                o[0] = Byte(packed, 0U);
+                o[1] = Byte(packed, 1U);
+                o += 2U;
+            }
+            return o - out;
+        }
+    };
+
+    template <ColorOrder ORDER>
+    struct Kernel<PF18BitsPerPixel, ORDER> {
+        // 4 pixels: 3 words in, 3 words out
+        static constexpr size_t BLOCK_PIXELS = 4U;
+
+        static size_t ConvertRow(const unsigned char rgb[], size_t pixelCount, unsigned char out[]) {
+            constexpr size_t FIRST = (ColorOrderRGB == ORDER) ? 0U : 2U;
+            constexpr size_t LAST = 2U - FIRST;
+            size_t i = 0U;
+            unsigned char* o = out;
+
+            if (IsWordAligned(rgb, out)) {
+                for (; (i + BLOCK_PIXELS) <= pixelCount; i += BLOCK_PIXELS) {
+                    const unsigned char* const px = &rgb[i * 3U];
+                    const uint32_t w0 = LoadWord(px);
+                    const uint32_t w1 = LoadWord(px + 4U);
+                    const uint32_t w2 = LoadWord(px + 8U);
+                    if (ColorOrderRGB == ORDER) {
+                        // Same layout as the source, only the two low bits of every channel go
+                        StoreWord(o, w0 & 0xFCFCFCFCU);
+                        StoreWord(o + 4U, w1 & 0xFCFCFCFCU);
+                        StoreWord(o + 8U, w2 & 0xFCFCFCFCU);
+                    } else {
+                        // Swap the first and last channel of every pixel
+                        StoreWord(o, (Byte(w0, 2U) | (Byte(w0, 1U) << 8U) | (Byte(w0, 0U) << 16U) | (Byte(w1, 1U) << 24U)) & 0xFCFCFCFCU);
+                        StoreWord(o + 4U, (Byte(w1, 0U) | (Byte(w0, 3U) << 8U) | (Byte(w2, 0U) << 16U) | (Byte(w1, 3U) << 24U)) & 0xFCFCFCFCU);
+                        StoreWord(o + 8U, (Byte(w1, 2U) | (Byte(w2, 3U) << 8U) | (Byte(w2, 2U) << 16U) | (Byte(w2, 1U) << 24U)) & 0xFCFCFCFCU);
+                    }
+                    o += 12U;
+                }
+            }
+            for (; i < pixelCount; ++i) {
+                // Read before written, out may be rgb
+                const unsigned char* const px = &rgb[i * 3U];
+                const unsigned char first = px[FIRST];
+                const unsigned char last = px[LAST];
+                o[0] = first & 0xFCU;
+                o[1] = px[1U] & 0xFCU;
+                o[2] = last & 0xFCU;
+                o += 3U;
+            }
+            return o - out;
+        }
+    };
+
+    /* Position of the next pixel of a rectangle, for the kernels that depend on it. The dithered kernels move it on
+     * by the pixels they convert, wrapping from column x1 back to x0 on the next row.
+     * */
+    typedef struct {
+        unsigned short x;
+        unsigned short y;
+        unsigned short x0;
+        unsigned short x1;
+    } Cursor;
+
+    typedef size_t (*DitherFunction)(const unsigned char rgb[], size_t pixelCount, unsigned char out[], Cursor* cursor);
+
+    // 4x4 Bayer matrix, thresholds in 1/16 of a quantization step
+    static constexpr unsigned char BAYER[4U][4U] = {
+        { 0U,  8U,  2U, 10U},
+        {12U,  4U, 14U,  6U},
+        { 3U, 11U,  1U,  9U},
+        {15U,  7U, 13U,  5U},
+    };
+
+    /* Channel values scaled so that the levels of BITS bits land on 0 and 255: v * (2^BITS - 1) / 255 in units of
+     * 1/2^(8 - BITS) of a level. Adding a threshold below one level then never carries past the top one.
+     * */
+    template <unsigned int BITS>
+    struct ScaleTable {
+        unsigned char value[256U];
+
+        constexpr ScaleTable() : value() {
+            for (unsigned int v = 0U; v < 256U; ++v) {
+                this->value[v] = (v * ((1U << BITS) - 1U) * (1U << (8U - BITS)) + 127U) / 255U;
+            }
+        }
+    };
+
+    template <unsigned int BITS>
+    static constexpr ScaleTable<BITS> Scale{};
+
+    /* Ordered dither to BITS bits: the scaled channel plus the pixel's threshold (in 1/16 of a level), truncated.
+     * Over a 4x4 area the levels average out to the source value, instead of the banding plain truncation
+     * leaves on gradients.
+     * */
+    template <unsigned int BITS>
+    inline unsigned int Dither(unsigned int channel, unsigned int threshold) {
+        return (Scale<BITS>.value[channel] + (threshold >> (BITS - 4U))) >> (8U - BITS);
+    }
+
+    template <PixelFormat PF, ColorOrder ORDER>
+    struct DitherKernel;
+
+    template <ColorOrder ORDER>
+    struct DitherKernel<PF12BitsPerPixel, ORDER> {
+        static constexpr size_t FIRST = (ColorOrderRGB == ORDER) ? 0U : 2U;
+        static constexpr size_t LAST = 2U - FIRST;
+
+        // The three 4 bit channels of a pixel in wire order, first one in the high nibble
+        static inline unsigned int Nibbles(const unsigned char px[], unsigned int threshold) {
+            return (Dither<4U>(px[FIRST], threshold) << 8U) | (Dither<4U>(px[1U], threshold) << 4U) | Dither<4U>(px[LAST], threshold);
+        }
+
+        static size_t ConvertRow(const unsigned char rgb[], size_t pixelCount, unsigned char out[], Cursor* cursor) {
+            unsigned char* o = out;
+            // First pixel of a pair that ended a row, completed by the first pixel of the next one
+            unsigned int pending = 0U;
+            bool hasPending = false;
+
+            while (0U < pixelCount) {
+                const size_t rowLeft = cursor->x1 + 1U - cursor->x;
+                const size_t run = (pixelCount < rowLeft) ? pixelCount : rowLeft;
+                const unsigned char* const thresholds = BAYER[cursor->y & 3U];
+                unsigned int x = cursor->x;
+                size_t i = 0U;
+
+                if (hasPending) {
+                    const unsigned int b = Nibbles(rgb, thresholds[x & 3U]);
+                    o[0] = pending >> 4U;
+                    o[1] = ((pending & 0x0FU) << 4U) | (b >> 8U);
+                    o[2] = b & 0xFFU;
+                    o += 3U;
+                    ++x;
+                    i = 1U;
+                    hasPending = false;
+                }
+                for (; (i + 2U) <= run; i += 2U) {
+                    const unsigned int a = Nibbles(&rgb[i * 3U], thresholds[x & 3U]);
+                    const unsigned int b = Nibbles(&rgb[i * 3U + 3U], thresholds[(x + 1U) & 3U]);
+                    o[0] = a >> 4U;
+                    o[1] = ((a & 0x0FU) << 4U) | (b >> 8U);
+                    o[2] = b & 0xFFU;
+                    o += 3U;
+                    x += 2U;
+                }
+                if (i < run) {
+                    pending = Nibbles(&rgb[i * 3U], thresholds[x & 3U]);
+                    hasPending = true;
+                }
+
+                rgb += run * 3U;
+                pixelCount -= run;
+                cursor->x += run;
+                if (cursor->x > cursor->x1) {
+                    cursor->x = cursor->x0;
+                    ++cursor->y;
+                }
+            }
+            if (hasPending) {
+                // Odd last pixel, padded as by the plain kernel
+                o[0] = pending >> 4U;
+                o[1] = (pending & 0x0FU) << 4U;
+                o += 2U;
+            }
+            return o - out;
+        }
+    };
+
+    template <ColorOrder ORDER>
+    struct DitherKernel<PF16BitsPerPixel, ORDER> {
+        static constexpr size_t FIRST = (ColorOrderRGB == ORDER) ? 0U : 2U;
+        static constexpr size_t LAST = 2U - FIRST;
+
+        static size_t ConvertRow(const unsigned char rgb[], size_t pixelCount, unsigned char out[], Cursor* cursor) {
+            unsigned char* o = out;
+
+            while (0U < pixelCount) {
+                const size_t rowLeft = cursor->x1 + 1U - cursor->x;
+                const size_t run = (pixelCount < rowLeft) ? pixelCount : rowLeft;
+                const unsigned char* const thresholds = BAYER[cursor->y & 3U];
+                const unsigned int x = cursor->x;
+
+                for (size_t i = 0U; i < run; ++i) {
+                    const unsigned char* const px = &rgb[i * 3U];
+                    const unsigned int threshold = thresholds[(x + i) & 3U];
+                    const unsigned int packed = (Dither<5U>(px[FIRST], threshold) << 11U) | (Dither<6U>(px[1U], threshold) << 5U) |
+                                                Dither<5U>(px[LAST], threshold);
+                    o[0] = packed >> 8U;
+                    o[1] = packed & 0xFFU;
+                    o += 2U;
+                }
+
+                rgb += run * 3U;
+                pixelCount -= run;
+                cursor->x += run;
+                if (cursor->x > cursor->x1) {
+                    cursor->x = cursor->x0;
+                    ++cursor->y;
+                }
+            }
+            return o - out;
+        }
+    };
+
+    template <ColorOrder ORDER>
+    struct DitherKernel<PF18BitsPerPixel, ORDER> {
+        static constexpr size_t FIRST = (ColorOrderRGB == ORDER) ? 0U : 2U;
+        static constexpr size_t LAST = 2U - FIRST;
+
+        static size_t ConvertRow(const unsigned char rgb[], size_t pixelCount, unsigned char out[], Cursor* cursor) {
+            unsigned char* o = out;
+
+            while (0U < pixelCount) {
+                const size_t rowLeft = cursor->x1 + 1U - cursor->x;
+                const size_t run = (pixelCount < rowLeft) ? pixelCount : rowLeft;
+                const unsigned char* const thresholds = BAYER[cursor->y & 3U];
+                const unsigned int x = cursor->x;
+
+                for (size_t i = 0U; i < run; ++i) {
+                    const unsigned char* const px = &rgb[i * 3U];
+                    const unsigned int threshold = thresholds[(x + i) & 3U];
+                    // Read before written, out may be rgb
+                    const unsigned int first = Dither<6U>(px[FIRST], threshold);
+                    const unsigned int green = Dither<6U>(px[1U], threshold);
+                    const unsigned int last = Dither<6U>(px[LAST], threshold);
+                    o[0] = first << 2U;
+                    o[1] = green << 2U;
+                    o[2] = last << 2U;
+                    o += 3U;
+                }
+
+                rgb += run * 3U;
+                pixelCount -= run;
+                cursor->x += run;
+                if (cursor->x > cursor->x1) {
+                    cursor->x = cursor->x0;
+                    ++cursor->y;
+                }
+            }
+            return o - out;
+        }
+    };
+
+    // Natural logarithm for the constant expression tables, x > 0
+    constexpr double Ln(double x) {
+        // x = m * 2^k with m in [1, 2), ln(m) = 2 atanh((m - 1) / (m + 1))
+        double k = 0.0;
+        while (x >= 2.0) {
+            x /= 2.0;
+            k += 1.0;
+        }
+        while (x < 1.0) {
+            x *= 2.0;
+            k -= 1.0;
+        }
+        const double z = (x - 1.0) / (x + 1.0);
+        double term = z;
+        double sum = 0.0;
+        for (unsigned int n = 1U; n < 40U; n += 2U) {
+            sum += term / n;
+            term *= z * z;
+        }
+        return 2.0 * sum + k * 0.69314718055994530942;
+    }
+
+    // e^x for the constant expression tables
+    constexpr double Exp(double x) {
+        // e^x = (e^(x / 2^8))^(2^8), the series converges in a few terms on the small argument
+        const double r = x / 256.0;
+        double term = 1.0;
+        double sum = 1.0;
+        for (unsigned int n = 1U; n < 16U; ++n) {
+            term *= r / n;
+            sum += term;
+        }
+        for (unsigned int i = 0U; i < 8U; ++i) {
+            sum *= sum;
+        }
+        return sum;
+    }
+
+    constexpr double Pow(double x, double y) {
+        return (x <= 0.0) ? 0.0 : Exp(y * Ln(x));
+    }
+
+    /* Conversion table for one PixelFormat and ColorOrder that folds gamma, brightness and quantization into one
+     * lookup per channel: code[c][v] is what source channel c (R, G, B) at value v contributes to the wire code of
+     * the pixel, the three are ORed together.
+     *   12 bits: the 12 bit code of the pixel (first channel sent in bits 11..8)
+     *   16 bits: the RGB565 word
+     *   18 bits: the three bytes, first one in bits 23..16
+     *
+     * Every channel goes through v' = 255 * brightness / 255 * (v / 255)^gamma and is rounded to the nearest level.
+     * The constructor is constexpr, so a table with fixed settings is built by the compiler and lives in flash:
+     *
+     *     static constexpr GC9A01Kernels::ColorLut PANEL_GAMMA(PF16BitsPerPixel, ColorOrderRGB, 2.2);
+     *
+     * Built at run time (e.g. for a brightness change) it takes one Pow per entry, a few ms on the RP2040.
+     * */
+    struct ColorLut {
+        PixelFormat pf;
+        ColorOrder order;
+        uint32_t code[3U][256U];
+
+        constexpr ColorLut(PixelFormat pf, ColorOrder order, double gamma = 1.0, unsigned char brightness = 255U)
+         : pf(pf), order(order), code() {
+            const unsigned int bits[3U] = {
+                (PF12BitsPerPixel == pf) ? 4U : ((PF16BitsPerPixel == pf) ? 5U : 6U),
+                (PF12BitsPerPixel == pf) ? 4U : 6U,
+                (PF12BitsPerPixel == pf) ? 4U : ((PF16BitsPerPixel == pf) ? 5U : 6U),
+            };
+            // Wire slot of each source channel: 0 is sent first
+            const unsigned int slot[3U] = {(ColorOrderRGB == order) ? 0U : 2U, 1U, (ColorOrderRGB == order) ? 2U : 0U};
+            const unsigned int shift12[3U] = {8U, 4U, 0U};
+            const unsigned int shift16[3U] = {11U, 5U, 0U};
+            const unsigned int shift18[3U] = {16U, 8U, 0U};
+
+            for (unsigned int v = 0U; v < 256U; ++v) {
+                const double linear = (1.0 == gamma) ? (v / 255.0) : Pow(v / 255.0, gamma);
+                const double corrected = linear * brightness;
+                for (unsigned int c = 0U; c < 3U; ++c) {
+                    const unsigned int levels = (1U << bits[c]) - 1U;
+                    const unsigned int level = static_cast<unsigned int>((corrected * levels) / 255.0 + 0.5);
+                    const unsigned int s = slot[c];
+                    this->code[c][v] = (PF12BitsPerPixel == pf) ? (level << shift12[s]) :
+                                       (PF16BitsPerPixel == pf) ? (level << shift16[s]) :
+                                                                  ((level << 2U) << shift18[s]);
+                }
+            }
+        }
+    };
+
+    template <PixelFormat PF>
+    struct LutKernel;
+
+    template <>
+    struct LutKernel<PF12BitsPerPixel> {
+        static size_t ConvertRow(const ColorLut& lut, const unsigned char rgb[], size_t pixelCount, unsigned char out[]) {
+            size_t i = 0U;
+            unsigned char* o = out;
+
+            for (; (i + 2U) <= pixelCount; i += 2U) {
+                const unsigned char* const px = &rgb[i * 3U];
+                const uint32_t a = lut.code[0U][px[0U]] | lut.code[1U][px[1U]] | lut.code[2U][px[2U]];
+                const uint32_t b = lut.code[0U][px[3U]] | lut.code[1U][px[4U]] | lut.code[2U][px[5U]];
+                o[0] = a >> 4U;
+                o[1] = ((a & 0x0FU) << 4U) | (b >> 8U);
+                o[2] = b & 0xFFU;
+                o += 3U;
+            }
+            if (i < pixelCount) {
+                // Odd last pixel, padded as by the plain kernel
+                const unsigned char* const px = &rgb[i * 3U];
+                const uint32_t a = lut.code[0U][px[0U]] | lut.code[1U][px[1U]] | lut.code[2U][px[2U]];
+                o[0] = a >> 4U;
+                o[1] = (a & 0x0FU) << 4U;
+                o += 2U;
+            }
+            return o - out;
+        }
+    };
+
+    template <>
+    struct LutKernel<PF16BitsPerPixel> {
+        static size_t ConvertRow(const ColorLut& lut, const unsigned char rgb[], size_t pixelCount, unsigned char out[]) {
+            unsigned char* o = out;
+            for (size_t i = 0U; i < pixelCount; ++i) {
+                const unsigned char* const px = &rgb[i * 3U];
+                const uint32_t word = lut.code[0U][px[0U]] | lut.code[1U][px[1U]] | lut.code[2U][px[2U]];
+                o[0] = word >> 8U;
+                o[1] = word & 0xFFU;
+                o += 2U;
+            }
+            return o - out;
+        }
+    };
+
+    template <>
+    struct LutKernel<PF18BitsPerPixel> {
+        static size_t ConvertRow(const ColorLut& lut, const unsigned char rgb[], size_t pixelCount, unsigned char out[]) {
+            unsigned char* o = out;
+            for (size_t i = 0U; i < pixelCount; ++i) {
+                const unsigned char* const px = &rgb[i * 3U];
+                const uint32_t bytes = lut.code[0U][px[0U]] | lut.code[1U][px[1U]] | lut.code[2U][px[2U]];
+                o[0] = bytes >> 16U;
+                o[1] = (bytes >> 8U) & 0xFFU;
+                o[2] = bytes & 0xFFU;
+                o += 3U;
+            }
+            return o - out;
+        }
+    };
+
+    // Converts through lut, in its pixel format and order
+    inline size_t ConvertWithLut(const ColorLut& lut, const unsigned char rgb[], size_t pixelCount, unsigned char out[]) {
+        switch (lut.pf)
+        {
+        case PF12BitsPerPixel:
+            return LutKernel<PF12BitsPerPixel>::ConvertRow(lut, rgb, pixelCount, out);
+        case PF16BitsPerPixel:
+            return LutKernel<PF16BitsPerPixel>::ConvertRow(lut, rgb, pixelCount, out);
+        case PF18BitsPerPixel:
+        default:
+            return LutKernel<PF18BitsPerPixel>::ConvertRow(lut, rgb, pixelCount, out);
+        }
+    }
+
+    // Picks the kernel for a transfer
+    inline ConvertFunction Select(PixelFormat pf, ColorOrder order) {
+        switch (pf)
+        {
+        case PF12BitsPerPixel:
+            return (ColorOrderRGB == order) ? &Kernel<PF12BitsPerPixel, ColorOrderRGB>::ConvertRow : &Kernel<PF12BitsPerPixel, ColorOrderBGR>::ConvertRow;
+        case PF16BitsPerPixel:
+            return (ColorOrderRGB == order) ? &Kernel<PF16BitsPerPixel, ColorOrderRGB>::ConvertRow : &Kernel<PF16BitsPerPixel, ColorOrderBGR>::ConvertRow;
+        case PF18BitsPerPixel:
+        default:
+            return (ColorOrderRGB == order) ? &Kernel<PF18BitsPerPixel, ColorOrderRGB>::ConvertRow : &Kernel<PF18BitsPerPixel, ColorOrderBGR>::ConvertRow;
+        }
+    }
+
+    // Picks the dithered kernel for a transfer
+    inline DitherFunction SelectDithered(PixelFormat pf, ColorOrder order) {
+        switch (pf)
+        {
+        case PF12BitsPerPixel:
+            return (ColorOrderRGB == order) ? &DitherKernel<PF12BitsPerPixel, ColorOrderRGB>::ConvertRow : &DitherKernel<PF12BitsPerPixel, ColorOrderBGR>::ConvertRow;
+        case PF16BitsPerPixel:
+            return (ColorOrderRGB == order) ? &DitherKernel<PF16BitsPerPixel, ColorOrderRGB>::ConvertRow : &DitherKernel<PF16BitsPerPixel, ColorOrderBGR>::ConvertRow;
+        case PF18BitsPerPixel:
+        default:
+            return (ColorOrderRGB == order) ? &DitherKernel<PF18BitsPerPixel, ColorOrderRGB>::ConvertRow : &DitherKernel<PF18BitsPerPixel, ColorOrderBGR>::ConvertRow;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,313 @@
+#include "GC9A01_Primitives.hpp"
+#include "GC9A01_Trig.hpp"
+
+namespace {
+    // Beyond any coordinate, for unbounded column ranges
+    constexpr int UNBOUNDED = 1 << 20;
+
+    inline int Min(int a, int b) { return (a < b) ? a : b; }
+    inline int Max(int a, int b) { return (a > b) ? a : b; }
+    inline int Abs(int a) { return (a < 0) ? -a : a; }
+
+    // Last column of row dy inside the circle of radius r (pixel centers within r + 1/2), -1 when the row misses it
+    int Extent(int r, int dy) {
+        const int squared = r * r + r - dy * dy;
+        return ((r < 0) || (squared < 0)) ? -1 : static_cast<int>(GC9A01Trig::ISqrt(squared));
+    }
+
+    // Rounded towards minus and plus infinity
+    int FloorDiv(int a, int b) {
+        const int q = a / b;
+        return ((0 != (a % b)) && ((a < 0) != (b < 0))) ? (q - 1) : q;
+    }
+    int CeilDiv(int a, int b) {
+        const int q = a / b;
+        return ((0 != (a % b)) && ((a < 0) == (b < 0))) ? (q + 1) : q;
+    }
+
+    // Columns x with a * x >= c, as [*lo, *hi] (empty when *lo > *hi)
+    void HalfLine(int a, int c, int* lo, int* hi) {
+        if (0 < a) {
+            *lo = CeilDiv(c, a);
+            *hi = UNBOUNDED;
+        } else if (0 > a) {
+            *lo = -UNBOUNDED;
+            *hi = FloorDiv(c, a);
+        } else {
+            *lo = (0 >= c) ? -UNBOUNDED : UNBOUNDED;
+            *hi = (0 >= c) ? UNBOUNDED : -UNBOUNDED;
+        }
+    }
+}
+
+GC9A01Primitives::GC9A01Primitives(const GC9A01& display)
+ : display(display), frameBuffer(nullptr), band(nullptr), color{0xFFU, 0xFFU, 0xFFU}, pendingCount(0U), spanCount(0U) { }
+
+void GC9A01Primitives::SetColor(unsigned char r, unsigned char g, unsigned char b) {
+    this->color[0] = r;
+    this->color[1] = g;
+    this->color[2] = b;
+}
+
+void GC9A01Primitives::GetClip(int* x0, int* y0, int* x1, int* y1) const {
+    if (nullptr != this->band) {
+        *x0 = this->band->GetX0();
+        *y0 = this->band->GetY0();
+        *x1 = this->band->GetX0() + this->band->GetWidth();
+        *y1 = this->band->GetY0() + this->band->GetRows();
+    } else {
+        *x0 = 0;
+        *y0 = 0;
+        *x1 = (nullptr != this->frameBuffer) ? this->frameBuffer->GetWidth() : MAX_WIDTH;
+        *y1 = (nullptr != this->frameBuffer) ? this->frameBuffer->GetHeight() : MAX_HEIGHT;
+    }
+}
+
+void GC9A01Primitives::Begin() {
+    this->pendingCount = 0U;
+    if ((nullptr == this->band) && (nullptr == this->frameBuffer)) {
+        this->display.BeginTransaction();
+    }
+}
+
+void GC9A01Primitives::End() {
+    for (size_t i = 0U; i < this->pendingCount; ++i) {
+        this->Send(this->pending[i]);
+    }
+    this->pendingCount = 0U;
+    if ((nullptr == this->band) && (nullptr == this->frameBuffer)) {
+        this->display.EndTransaction();
+    }
+}
+
+void GC9A01Primitives::Send(const Span& span) {
+    ++this->spanCount;
+    if (nullptr != this->band) {
+        this->band->FillRect(span.x, span.y, span.w, span.h, this->color[0], this->color[1], this->color[2]);
+    } else if (nullptr != this->frameBuffer) {
+        this->frameBuffer->FillRect(span.x, span.y, span.w, span.h, this->color[0], this->color[1], this->color[2]);
+    } else {
+        this->display.FillArea(this->color[0], this->color[1], this->color[2], span.x, span.y, span.w, span.h);
+    }
+}
+
+void GC9A01Primitives::AddSpan(int x, int y, int w, int h) {
+    int clipX0 = 0;
+    int clipY0 = 0;
+    int clipX1 = 0;
+    int clipY1 = 0;
+    this->GetClip(&clipX0, &clipY0, &clipX1, &clipY1);
+    const int x0 = Max(x, clipX0);
+    const int y0 = Max(y, clipY0);
+    const int x1 = Min(x + w, clipX1);
+    const int y1 = Min(y + h, clipY1);
+    if ((x0 >= x1) || (y0 >= y1)) {
+        return;
+    }
+
+    // Same columns right below a pending span: one taller window
+    for (size_t i = 0U; i < this->pendingCount; ++i) {
+        Span& span = this->pending[i];
+        if ((x0 == span.x) && ((x1 - x0) == span.w) && (y0 == (span.y + span.h))) {
+            span.h += y1 - y0;
+            return;
+        }
+    }
+
+    // Shapes go top to bottom, a span ending above this row will not grow any more
+    size_t kept = 0U;
+    for (size_t i = 0U; i < this->pendingCount; ++i) {
+        if ((this->pending[i].y + this->pending[i].h) < y0) {
+            this->Send(this->pending[i]);
+        } else {
+            this->pending[kept] = this->pending[i];
+            ++kept;
+        }
+    }
+    this->pendingCount = kept;
+    if (MAX_PENDING == this->pendingCount) {
+        this->Send(this->pending[0]);
+        for (size_t i = 1U; i < MAX_PENDING; ++i) {
+            this->pending[i - 1U] = this->pending[i];
+        }
+        --this->pendingCount;
+    }
+    this->pending[this->pendingCount] = {static_cast<short>(x0), static_cast<short>(y0), static_cast<short>(x1 - x0), static_cast<short>(y1 - y0)};
+    ++this->pendingCount;
+}
+
+void GC9A01Primitives::AddRowSpan(int cx, int cy, int dy, int x0, int x1, const Sector* sector) {
+    if (nullptr == sector) {
+        this->AddSpan(cx + x0, cy + dy, x1 - x0 + 1, 1);
+        return;
+    }
+
+    /* Column x of the row is clockwise from the start direction when cross(start, (x, dy)) >= 0 and before the end
+     * direction when cross((x, dy), end) >= 0. Each is a half line of the row: a sweep up to 180 degrees takes both,
+     * a wider one either of them.
+     * */
+    int startLo = 0;
+    int startHi = 0;
+    int endLo = 0;
+    int endHi = 0;
+    HalfLine(-sector->startY, -sector->startX * dy, &startLo, &startHi);
+    HalfLine(sector->endY, sector->endX * dy, &endLo, &endHi);
+
+    if (!sector->wide) {
+        const int lo = Max(x0, Max(startLo, endLo));
+        const int hi = Min(x1, Min(startHi, endHi));
+        if (lo <= hi) {
+            this->AddSpan(cx + lo, cy + dy, hi - lo + 1, 1);
+        }
+        return;
+    }
+
+    const int lo0 = Max(x0, startLo);
+    const int hi0 = Min(x1, startHi);
+    const int lo1 = Max(x0, endLo);
+    const int hi1 = Min(x1, endHi);
+    if ((lo0 <= hi0) && (lo1 <= hi1) && (lo0 <= (hi1 + 1)) && (lo1 <= (hi0 + 1))) {
+        // Overlapping or touching, one span
+        this->AddSpan(cx + Min(lo0, lo1), cy + dy, Max(hi0, hi1) - Min(lo0, lo1) + 1, 1);
+        return;
+    }
+    if (lo0 <= hi0) {
+        this->AddSpan(cx + lo0, cy + dy, hi0 - lo0 + 1, 1);
+    }
+    if (lo1 <= hi1) {
+        this->AddSpan(cx + lo1, cy + dy, hi1 - lo1 + 1, 1);
+    }
+}
+
+void GC9A01Primitives::Ring(short cx, short cy, short r, short thickness, const Sector* sector) {
+    if ((r < 0) || (thickness <= 0)) {
+        return;
+    }
+    int clipX0 = 0;
+    int clipY0 = 0;
+    int clipX1 = 0;
+    int clipY1 = 0;
+    this->GetClip(&clipX0, &clipY0, &clipX1, &clipY1);
+    const int inner = r - thickness;
+    const int dyFrom = Max(-r, clipY0 - cy);
+    const int dyTo = Min(r, clipY1 - 1 - cy);
+
+    this->Begin();
+    for (int dy = dyFrom; dy <= dyTo; ++dy) {
+        const int row = Abs(dy);
+        const int outerX = Extent(r, row);
+        if (0 > outerX) {
+            continue;
+        }
+        /* Right half of the row runs from past the hole to outerX. It also reaches back to the end of the next
+         * row outwards, otherwise a thin ring breaks up where its edge moves more than a pixel per row.
+         * */
+        const int from = Min(Min(Extent(inner, row) + 1, Extent(r, row + 1) + 1), outerX);
+        if (0 >= from) {
+            this->AddRowSpan(cx, cy, dy, -outerX, outerX, sector);
+        } else {
+            this->AddRowSpan(cx, cy, dy, -outerX, -from, sector);
+            this->AddRowSpan(cx, cy, dy, from, outerX, sector);
+        }
+    }
+    this->End();
+}
+
+void GC9A01Primitives::DrawHLine(short x, short y, short w) {
+    this->Begin();
+    this->AddSpan(x, y, w, 1);
+    this->End();
+}
+
+void GC9A01Primitives::DrawVLine(short x, short y, short h) {
+    this->Begin();
+    this->AddSpan(x, y, 1, h);
+    this->End();
+}
+
+void GC9A01Primitives::DrawLine(short x0, short y0, short x1, short y1) {
+    // Bresenham along the major axis, each run of pixels at the same minor coordinate is one span
+    const bool steep = Abs(y1 - y0) > Abs(x1 - x0);
+    const int major = steep ? Abs(y1 - y0) : Abs(x1 - x0);
+    const int minor = steep ? Abs(x1 - x0) : Abs(y1 - y0);
+    const int majorStep = ((steep ? y1 : x1) < (steep ? y0 : x0)) ? -1 : 1;
+    const int minorStep = ((steep ? x1 : y1) < (steep ? x0 : y0)) ? -1 : 1;
+    int a = steep ? y0 : x0;
+    int b = steep ? x0 : y0;
+    int runStart = a;
+    int error = major / 2;
+
+    this->Begin();
+    for (int i = 0; i <= major; ++i) {
+        const bool last = (i == major);
+        if (!last) {
+            error -= minor;
+        }
+        if (last || (error < 0)) {
+            const int from = Min(runStart, a);
+            const int length = Abs(a - runStart) + 1;
+            if (steep) {
+                this->AddSpan(b, from, 1, length);
+            } else {
+                this->AddSpan(from, b, length, 1);
+            }
+            b += minorStep;
+            error += major;
+            runStart = a + majorStep;
+        }
+        a += majorStep;
+    }
+    this->End();
+}
+
+void GC9A01Primitives::DrawRect(short x, short y, short w, short h, short thickness) {
+    if (((2 * thickness) >= w) || ((2 * thickness) >= h)) {
+        this->FillRect(x, y, w, h);
+        return;
+    }
+    this->Begin();
+    this->AddSpan(x, y, w, thickness);
+    this->AddSpan(x, y + thickness, thickness, h - 2 * thickness);
+    this->AddSpan(x + w - thickness, y + thickness, thickness, h - 2 * thickness);
+    this->AddSpan(x, y + h - thickness, w, thickness);
+    this->End();
+}
+
+void GC9A01Primitives::FillRect(short x, short y, short w, short h) {
+    this->Begin();
+    this->AddSpan(x, y, w, h);
+    this->End();
+}
+
+void GC9A01Primitives::DrawCircle(short cx, short cy, short r, short thickness) {
+    this->Ring(cx, cy, r, thickness, nullptr);
+}
+
+void GC9A01Primitives::FillCircle(short cx, short cy, short r) {
+    this->Ring(cx, cy, r, r + 1, nullptr);
+}
+
+void GC9A01Primitives::DrawArc(short cx, short cy, short r, short thickness, int startAngle, int endAngle) {
+    int sweep = endAngle - startAngle;
+    if (sweep < 0) {
+        sweep = (sweep % 360) + 360;
+    }
+    if (0 == sweep) {
+        return;
+    }
+    if (sweep >= 360) {
+        this->Ring(cx, cy, r, thickness, nullptr);
+        return;
+    }
+
+    // Directions with y pointing down, so that growing angles turn clockwise on the screen
+    const unsigned short start = GC9A01Trig::FromDegrees(startAngle);
+    const unsigned short end = GC9A01Trig::FromDegrees(startAngle + sweep);
+    Sector sector;
+    sector.startX = GC9A01Trig::Sin(start);
+    sector.startY = -GC9A01Trig::Cos(start);
+    sector.endX = GC9A01Trig::Sin(end);
+    sector.endY = -GC9A01Trig::Cos(end);
+    sector.wide = sweep > 180;
+    this->Ring(cx, cy, r, thickness, &sector);
+}
@@ -0,0 +1,91 @@
+#ifndef GC9A01_PRIMITIVES_HPP
+#define GC9A01_PRIMITIVES_HPP
+
+#include "GC9A01.hpp"
+#include "GC9A01_FrameBuffer.hpp"
+#include "GC9A01_BandRenderer.hpp"
+
+/* Lines, rectangles, circles and arcs in one solid color, rasterized into spans: rectangles of pixels (mostly one
+ * row high) that go out as a single FillArea each, i.e. one short window and a DMA repeated color. Nothing is
+ * built in RAM and no pixel gets its own address window.
+ *
+ * Spans of consecutive rows with the same columns are joined before they are sent, so the vertical parts of an
+ * outline or the middle of a disc are one window rather than one per row. A shape is drawn inside one transaction.
+ *
+ * With a framebuffer set (SetFrameBuffer) the spans are filled into it instead and marked dirty, for its next Flush().
+ * With a band set (SetBand) they are filled into the band, which lets a GC9A01BandRenderer scene use the primitives.
+ *
+ * Coordinates are signed and shapes are clipped to the target, so they can run off the screen.
+ * */
+class GC9A01Primitives
+{
+private:
+    // Spans held back to be joined with the rows below
+    static constexpr size_t MAX_PENDING = 4U;
+
+    typedef struct {
+        short x;
+        short y;
+        short w;
+        short h;
+    } Span;
+
+    // Arc limits as directions (clockwise from 12 o'clock, scaled by 2^14) and whether it sweeps more than 180 degrees
+    typedef struct {
+        int startX;
+        int startY;
+        int endX;
+        int endY;
+        bool wide;
+    } Sector;
+
+    const GC9A01& display;
+    GC9A01FrameBuffer* frameBuffer;
+    GC9A01Band* band;
+    unsigned char color[RGB_COUNT];
+    Span pending[MAX_PENDING];
+    size_t pendingCount;
+    size_t spanCount;
+
+    // Area of the target that can be drawn, x1 and y1 excluded
+    void GetClip(int* x0, int* y0, int* x1, int* y1) const;
+    void Begin();
+    void End();
+    // Clips x, y, w, h to the target and joins it with a pending span or queues it
+    void AddSpan(int x, int y, int w, int h);
+    void Send(const Span& span);
+    // Columns cx + [x0, x1] of row cy + dy, clipped to the sector (around cx, cy) when there is one
+    void AddRowSpan(int cx, int cy, int dy, int x0, int x1, const Sector* sector);
+    // Ring of outer radius r and thickness pixels, optionally limited to a sector
+    void Ring(short cx, short cy, short r, short thickness, const Sector* sector);
+public:
+    explicit GC9A01Primitives(const GC9A01& display);
+    // Draws into frameBuffer from now on, nullptr to draw to the panel again
+    inline void SetFrameBuffer(GC9A01FrameBuffer* frameBuffer) { this->frameBuffer = frameBuffer; }
+    inline GC9A01FrameBuffer* GetFrameBuffer() const { return this->frameBuffer; }
+    // Draws into band from now on (before any framebuffer), nullptr to stop
+    inline void SetBand(GC9A01Band* band) { this->band = band; }
+    void SetColor(unsigned char r, unsigned char g, unsigned char b);
+    // Spans sent (or filled into the framebuffer) so far
+    inline size_t GetSpanCount() const { return this->spanCount; }
+    inline void ResetSpanCount() { this->spanCount = 0U; }
+
+    void DrawHLine(short x, short y, short w);
+    void DrawVLine(short x, short y, short h);
+    // One pixel wide line from x0, y0 to x1, y1 (both ends included), sent as one span per step of the minor axis
+    void DrawLine(short x0, short y0, short x1, short y1);
+    // Outline of the rectangle x, y, w, h, thickness pixels inwards
+    void DrawRect(short x, short y, short w, short h, short thickness = 1);
+    void FillRect(short x, short y, short w, short h);
+    /* Outline of the circle of radius r around cx, cy, thickness pixels inwards. A pixel is on it when its center is
+     * within r + 1/2 of cx, cy and not within r - thickness + 1/2, one pixel rings stay 8-connected.
+     * */
+    void DrawCircle(short cx, short cy, short r, short thickness = 1);
+    void FillCircle(short cx, short cy, short r);
+    /* Part of DrawCircle from startAngle to endAngle, in degrees clockwise from 12 o'clock (so a gauge from 225 to
+     * 135 sweeps 270 degrees through the top). A sweep of 360 degrees or more draws the whole ring.
+     * */
+    void DrawArc(short cx, short cy, short r, short thickness, int startAngle, int endAngle);
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef GC9A01_ROUND_HPP
+#define GC9A01_ROUND_HPP
+
+#include "GC9A01.hpp"
+#include "GC9A01_Trig.hpp"
+
+/* Visible area of the round panel: the disc of diameter MAX_WIDTH inscribed in the 240x240 frame memory.
+ *
+ * A pixel is visible when its center lies inside the circle, which leaves 45 244 of the 57 600 pixels
+ * (the corners are the other 21.5 %). Every row is one chord, symmetric around the vertical axis, so the
+ * table only keeps the first visible column of each row.
+ * */
+namespace GC9A01Round {
+    struct SpanTable {
+        unsigned char left[MAX_HEIGHT];
+        size_t visiblePixels;
+
+        constexpr SpanTable() : left(), visiblePixels(0U) {
+            // Doubled coordinates keep the pixel centers integer: (2x + 1 - 240)^2 + (2y + 1 - 240)^2 <= 240^2
+            for (unsigned int y = 0U; y < MAX_HEIGHT; ++y) {
+                const unsigned int dy = (2U * y + 1U > MAX_HEIGHT) ? (2U * y + 1U - MAX_HEIGHT) : (MAX_HEIGHT - 2U * y - 1U);
+                const unsigned int halfWidth = GC9A01Trig::ISqrt(MAX_WIDTH * MAX_WIDTH - dy * dy);
+                this->left[y] = (MAX_WIDTH - halfWidth) / 2U;
+                this->visiblePixels += MAX_WIDTH - 2U * this->left[y];
+            }
+        }
+    };
+
+    static constexpr SpanTable Spans{};
+
+    // First visible column of row y, the chord runs to MAX_WIDTH - 1 - GetLeft(y)
+    inline unsigned short GetLeft(unsigned short y) { return Spans.left[y]; }
+
+    /* Visible part of row y within the columns [x0, x0 + w): its first column and pixel count (0 when nothing
+     * is visible). Returns how many rows from y (up to yEnd) share that same part, so they can go out as one window.
+     * */
+    inline unsigned short GetRun(unsigned short y, unsigned short yEnd, unsigned short x0, unsigned short w,
+                                 unsigned short* left, unsigned short* count) {
+        const unsigned char chordLeft = Spans.left[y];
+        const unsigned short from = (x0 > chordLeft) ? x0 : chordLeft;
+        const unsigned short to = ((x0 + w) < (MAX_WIDTH - chordLeft)) ? (x0 + w) : (MAX_WIDTH - chordLeft);
+        *left = from;
+        *count = (to > from) ? (to - from) : 0U;
+
+        unsigned short rows = 1U;
+        while ((y + rows) < yEnd) {
+            const unsigned char nextLeft = Spans.left[y + rows];
+            const unsigned short nextFrom = (x0 > nextLeft) ? x0 : nextLeft;
+            const unsigned short nextTo = ((x0 + w) < (MAX_WIDTH - nextLeft)) ? (x0 + w) : (MAX_WIDTH - nextLeft);
+            const unsigned short nextCount = (nextTo > nextFrom) ? (nextTo - nextFrom) : 0U;
+            if ((nextCount != *count) || ((0U != nextCount) && (nextFrom != from))) {
+                break;
+            }
+            ++rows;
+        }
+        return rows;
+    }
+}
+
+#endif
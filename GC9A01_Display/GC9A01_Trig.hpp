@@ -0,0 +1,88 @@
+#ifndef GC9A01_TRIG_HPP
+#define GC9A01_TRIG_HPP
+
+/* Fixed point sine, cosine and square root for code running on the FPU-less Cortex-M0+.
+ *
+ * Angles are binary: a full turn is 65536, so an unsigned short wraps around by itself. Results are Q14
+ * (ONE = 16384 stands for 1.0). A quarter wave of 256 steps is built by the compiler and interpolated
+ * linearly, which keeps the error within one unit of Q14.
+ * */
+namespace GC9A01Trig {
+    constexpr int ONE = 1 << 14;
+    constexpr unsigned int FULL_TURN = 1U << 16U;
+    constexpr unsigned int QUARTER_TURN = FULL_TURN / 4U;
+    constexpr unsigned int QUARTER_STEPS = 256U;
+
+    // Taylor series, only used to build the table (x within [0, pi / 2])
+    constexpr double SinSeries(double x) {
+        double term = x;
+        double sum = x;
+        for (int n = 1; n < 12; ++n) {
+            term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+            sum += term;
+        }
+        return sum;
+    }
+
+    struct QuarterWave {
+        // One extra entry so that interpolating right at 90 degrees stays inside the table
+        short value[QUARTER_STEPS + 2U];
+
+        constexpr QuarterWave() : value() {
+            for (unsigned int i = 0U; i <= QUARTER_STEPS; ++i) {
+                const double x = (3.14159265358979323846 / 2.0) * i / QUARTER_STEPS;
+                this->value[i] = static_cast<short>(SinSeries(x) * ONE + 0.5);
+            }
+            this->value[QUARTER_STEPS + 1U] = this->value[QUARTER_STEPS];
+        }
+    };
+
+    static constexpr QuarterWave Quarter{};
+
+    // sin(angle) in Q14
+    inline int Sin(unsigned short angle) {
+        constexpr unsigned int FRACTION_BITS = 6U;
+        const unsigned int quadrant = angle >> 14U;
+        unsigned int offset = angle & (QUARTER_TURN - 1U);
+        if (0U != (quadrant & 1U)) {
+            // Second and fourth quadrants run the quarter wave backwards
+            offset = QUARTER_TURN - offset;
+        }
+        const unsigned int index = offset >> FRACTION_BITS;
+        const int fraction = offset & ((1U << FRACTION_BITS) - 1U);
+        const int low = Quarter.value[index];
+        const int value = low + (((Quarter.value[index + 1U] - low) * fraction + (1 << (FRACTION_BITS - 1U))) >> FRACTION_BITS);
+        return (quadrant < 2U) ? value : -value;
+    }
+
+    // cos(angle) in Q14
+    inline int Cos(unsigned short angle) {
+        return Sin(static_cast<unsigned short>(angle + QUARTER_TURN));
+    }
+
+    // Largest root with root * root <= value, one bit per step, usable in constant expressions
+    constexpr unsigned int ISqrt(unsigned int value) {
+        unsigned int root = 0U;
+        unsigned int bit = 1U << 30U;
+        while (bit > value) {
+            bit >>= 2U;
+        }
+        while (0U != bit) {
+            if (value >= (root + bit)) {
+                value -= root + bit;
+                root = (root >> 1U) + bit;
+            } else {
+                root >>= 1U;
+            }
+            bit >>= 2U;
+        }
+        return root;
+    }
+
+    // Binary angle of a whole number of degrees, rounded
+    constexpr unsigned short FromDegrees(int degrees) {
+        return static_cast<unsigned short>(((((degrees % 360) + 360) % 360) * FULL_TURN + 180U) / 360U);
+    }
+}
+
+#endif